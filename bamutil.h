@@ -13,6 +13,7 @@
 #include "htslib/sam.h"
 #include "htslib/hts.h"
 #include "htslib/faidx.h"
+#include "ntutil.h"
 
 /** some usefule functions to operate bam file */
 namespace bamutil{
@@ -42,11 +43,8 @@ namespace bamutil{
      * @return read seqence of the alignment
      */
     inline std::string getSeq(const bam1_t* b){
-        uint8_t* data = bam_get_seq(b);
         std::string seq(b->core.l_qseq, '\0');
-        for(int32_t i = 0; i < b->core.l_qseq; ++i){
-            seq[i] = seq_nt16_str[bam_seqi(data, i)];
-        }
+        ntutil::decodeNt16(bam_get_seq(b), b->core.l_qseq, &seq[0]);
         return seq;
     }
     
@@ -0,0 +1,304 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <thread>
+#include <zlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "filereader.h"
+
+/** Structure to hold result of one benchmark */
+struct BenchResult{
+    std::string input;           ///< input description
+    std::string method;          ///< method benchmarked
+    uint64_t bytes = 0;          ///< Bytes processed in each run
+    uint64_t lines = 0;          ///< lines found in each run
+    std::vector<double> seconds; ///< seconds used by each run
+};
+
+/** run a function repeatedly and record seconds of each run
+ * @param r BenchResult to store seconds and lines in
+ * @param repeat number of runs
+ * @param f function returning number of lines found
+ */
+template<typename F>
+void timeRuns(BenchResult& r, int repeat, F f){
+    for(int i = 0; i < repeat; ++i){
+        auto beg = std::chrono::steady_clock::now();
+        r.lines = f();
+        r.seconds.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - beg).count());
+    }
+}
+
+/** output a benchmark result as a tsv line
+ * @param r benchmark result
+ */
+void report(const BenchResult& r){
+    double best = *std::min_element(r.seconds.begin(), r.seconds.end());
+    std::cout << r.input << "\t" << r.method << "\t" << r.bytes << "\t" << r.lines << "\t" << best << "\t" << r.bytes / 1048576.0 / best << std::endl;
+}
+
+/** write a file of BED-like short lines
+ * @param fn output file
+ * @param bytes approximate size of file
+ */
+void makeShortLines(const std::string& fn, uint64_t bytes){
+    std::ofstream fw(fn);
+    std::mt19937 rng(1);
+    std::string line;
+    for(uint64_t written = 0, i = 0; written < bytes; written += line.size(), ++i){
+        uint32_t beg = rng() % 200000000;
+        line = "chr" + std::to_string(1 + rng() % 22) + "\t" + std::to_string(beg) + "\t" + std::to_string(beg + 100 + rng() % 900) + "\tpeak" + std::to_string(i) + "\n";
+        fw << line;
+    }
+}
+
+/** write a file of FASTA-like records with long unwrapped sequence lines
+ * @param fn output file
+ * @param bytes approximate size of file
+ */
+void makeLongLines(const std::string& fn, uint64_t bytes){
+    std::ofstream fw(fn);
+    std::mt19937 rng(2);
+    std::string seq;
+    for(uint64_t written = 0, i = 0; written < bytes; written += seq.size() + 16, ++i){
+        seq.resize(5000 + rng() % 10000);
+        for(auto& c: seq){
+            c = "ACGT"[rng() & 3];
+        }
+        fw << ">contig" << i << "\n" << seq << "\n";
+    }
+}
+
+/** compress a file into gzip format(not BGZF, so it is inflated by zlib in FileReader)
+ * @param src input plain file
+ * @param dst output gzip file
+ */
+void makeGzip(const std::string& src, const std::string& dst){
+    std::ifstream fr(src, std::ios::binary);
+    gzFile fw = gzopen(dst.c_str(), "wb");
+    std::vector<char> buf(1 << 20);
+    while(fr.read(buf.data(), buf.size()) || fr.gcount() > 0){
+        gzwrite(fw, buf.data(), fr.gcount());
+    }
+    gzclose(fw);
+}
+
+/** read all lines of a file with FileReader
+ * @param fn input file
+ * @param bufSize size of each read from file
+ * @param pool pool to get read buffers from, NULL to allocate them
+ * @return number of lines read
+ */
+uint64_t readLines(const std::string& fn, int32_t bufSize, ReadBufferPool* pool = NULL){
+    FileReader reader(fn, false, 1, bufSize, pool);
+    std::string_view line;
+    uint64_t lines = 0;
+    while(reader.getline(line)){
+        ++lines;
+    }
+    return lines;
+}
+
+/** read all lines of a file through a named pipe with FileReader, the file is written into the pipe by another thread
+ * @param fn input file
+ * @param fifo path of the named pipe to create
+ * @param bufSize size of each read from pipe
+ * @return number of lines read
+ */
+uint64_t readLinesFromPipe(const std::string& fn, const std::string& fifo, int32_t bufSize){
+    if(mkfifo(fifo.c_str(), 0600) != 0){
+        std::cerr << "Failed to create named pipe: " << fifo << std::endl;
+        std::exit(1);
+    }
+    std::thread writer([&]{
+        std::ifstream fr(fn, std::ios::binary);
+        FILE* fw = std::fopen(fifo.c_str(), "wb");
+        std::vector<char> buf(1 << 16);
+        while(fr.read(buf.data(), buf.size()) || fr.gcount() > 0){
+            std::fwrite(buf.data(), 1, fr.gcount(), fw);
+        }
+        std::fclose(fw);
+    });
+    uint64_t lines = readLines(fifo, bufSize);
+    writer.join();
+    std::remove(fifo.c_str());
+    return lines;
+}
+
+/** count lines one character at a time, as getline did before the vectorized scanner
+ * @param beg pointer to the first character
+ * @param end pointer past the last character
+ * @return number of line breaks
+ */
+uint64_t countLinesScalar(const char* beg, const char* end){
+    uint64_t lines = 0;
+    for(const char* p = beg; p < end; ++p){
+        if(*p == '\r' || *p == '\n'){
+            ++lines;
+        }
+    }
+    return lines;
+}
+
+/** count lines with FileReader::findLineBreak
+ * @param beg pointer to the first character
+ * @param end pointer past the last character
+ * @return number of line breaks
+ */
+uint64_t countLinesSimd(const char* beg, const char* end){
+    uint64_t lines = 0;
+    for(const char* p = FileReader::findLineBreak(beg, end); p < end; p = FileReader::findLineBreak(p + 1, end)){
+        ++lines;
+    }
+    return lines;
+}
+
+/** benchmark line scanning of a file in memory and through FileReader::getline
+ * @param name input description
+ * @param fn input file
+ * @param repeat number of runs
+ */
+void benchScan(const std::string& name, const std::string& fn, int repeat){
+    std::ifstream fr(fn, std::ios::binary);
+    std::string data((std::istreambuf_iterator<char>(fr)), std::istreambuf_iterator<char>());
+    BenchResult scalar, simd, getline;
+    scalar.input = simd.input = getline.input = name;
+    scalar.bytes = simd.bytes = getline.bytes = data.size();
+    scalar.method = "scan_scalar";
+    simd.method = "scan_simd";
+    getline.method = "getline_view";
+    timeRuns(scalar, repeat, [&]{return countLinesScalar(data.data(), data.data() + data.size());});
+    timeRuns(simd, repeat, [&]{return countLinesSimd(data.data(), data.data() + data.size());});
+    timeRuns(getline, repeat, [&]{
+        FileReader reader(fn);
+        std::string_view line;
+        uint64_t lines = 0;
+        while(reader.getline(line)){
+            ++lines;
+        }
+        return lines;
+    });
+    report(scalar);
+    report(simd);
+    report(getline);
+}
+
+/** benchmark FileReader throughput with different read buffer sizes on local gzip file and plain file from a pipe\n
+ * local plain files are memory mapped, the read buffer size only matters to compressed files and pipes
+ * @param plainFile plain input file
+ * @param gzFile gzip input file
+ * @param prefix prefix of named pipe to create
+ * @param repeat number of runs
+ */
+void benchBufSize(const std::string& plainFile, const std::string& gzFile, const std::string& prefix, int repeat){
+    struct stat info;
+    stat(plainFile.c_str(), &info);
+    for(int32_t bufSize = (1 << 16); bufSize <= (1 << 24); bufSize <<= 2){
+        BenchResult disk, pipe;
+        disk.input = "local_gzip";
+        pipe.input = "pipe_plain";
+        disk.method = pipe.method = "bufsize_" + std::to_string(bufSize);
+        disk.bytes = pipe.bytes = info.st_size;
+        timeRuns(disk, repeat, [&]{return readLines(gzFile, bufSize);});
+        timeRuns(pipe, repeat, [&]{return readLinesFromPipe(plainFile, prefix + ".fifo", bufSize);});
+        report(disk);
+        report(pipe);
+    }
+}
+
+/** benchmark FileReader on many small gzip files with and without a shared ReadBufferPool
+ * @param plainFile plain input file to take lines of small files from
+ * @param prefix prefix of small files to create
+ * @param nfiles number of small files
+ * @param repeat number of runs
+ */
+void benchSmallFiles(const std::string& plainFile, const std::string& prefix, int nfiles, int repeat){
+    std::vector<std::string> files;
+    std::ifstream fr(plainFile);
+    std::string line;
+    uint64_t bytes = 0;
+    for(int i = 0; i < nfiles; ++i){
+        files.push_back(prefix + ".small" + std::to_string(i) + ".gz");
+        gzFile fw = gzopen(files.back().c_str(), "wb");
+        for(int j = 0; j < 100 && std::getline(fr, line); ++j){
+            line.append("\n");
+            gzwrite(fw, line.data(), line.size());
+            bytes += line.size();
+        }
+        gzclose(fw);
+    }
+    int32_t bufSize = (1 << 20);
+    ReadBufferPool pool(bufSize);
+    BenchResult alloc, pooled;
+    alloc.input = pooled.input = "small_gzip_x" + std::to_string(nfiles);
+    alloc.method = "no_pool";
+    pooled.method = "pool";
+    alloc.bytes = pooled.bytes = bytes;
+    timeRuns(alloc, repeat, [&]{
+        uint64_t lines = 0;
+        for(auto& f: files){
+            lines += readLines(f, bufSize);
+        }
+        return lines;
+    });
+    timeRuns(pooled, repeat, [&]{
+        uint64_t lines = 0;
+        for(auto& f: files){
+            lines += readLines(f, bufSize, &pool);
+        }
+        return lines;
+    });
+    report(alloc);
+    report(pooled);
+    for(auto& f: files){
+        std::remove(f.c_str());
+    }
+}
+
+int main(int argc, char** argv){
+    uint64_t sizeMB = 1024;
+    int repeat = 3;
+    int nfiles = 2000;
+    std::string dir = "/tmp";
+    for(int i = 1; i < argc; ++i){
+        std::string arg = argv[i];
+        if(arg == "-s" && i + 1 < argc){
+            sizeMB = std::max(1, std::atoi(argv[++i]));
+        }else if(arg == "-r" && i + 1 < argc){
+            repeat = std::max(1, std::atoi(argv[++i]));
+        }else if(arg == "-n" && i + 1 < argc){
+            nfiles = std::max(1, std::atoi(argv[++i]));
+        }else if(arg == "-d" && i + 1 < argc){
+            dir = argv[++i];
+        }else{
+            fprintf(stderr, "Usage: %s [options]\n", argv[0]);
+            fprintf(stderr, "  -s size     MB of each generated input [%lu]\n", (unsigned long)sizeMB);
+            fprintf(stderr, "  -r repeat   number of runs of each method [%d]\n", repeat);
+            fprintf(stderr, "  -n nfiles   number of small files to read with and without buffer pool [%d]\n", nfiles);
+            fprintf(stderr, "  -d dir      directory to write generated inputs to [%s]\n", dir.c_str());
+            return 1;
+        }
+    }
+    std::string prefix = dir + "/benchFileReader." + std::to_string(getpid());
+    std::string shortFile = prefix + ".bed";
+    std::string longFile = prefix + ".fa";
+    makeShortLines(shortFile, sizeMB << 20);
+    makeLongLines(longFile, sizeMB << 20);
+    std::cout << "input\tmethod\tbytes\tlines\tbest_seconds\tmb_per_second" << std::endl;
+    benchScan("short_lines", shortFile, repeat);
+    benchScan("long_lines", longFile, repeat);
+    std::string gzFile = shortFile + ".gz";
+    makeGzip(shortFile, gzFile);
+    benchBufSize(shortFile, gzFile, prefix, repeat);
+    benchSmallFiles(shortFile, prefix, nfiles, repeat);
+    std::remove(gzFile.c_str());
+    std::remove(shortFile.c_str());
+    std::remove(longFile.c_str());
+    return 0;
+}
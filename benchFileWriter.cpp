@@ -0,0 +1,143 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "filewriter.h"
+
+/** Structure to hold fields of one TSV row */
+struct Row{
+    int32_t chr;  ///< chromosome number
+    int32_t beg;  ///< start position
+    int32_t end;  ///< end position
+    double score; ///< score
+    char strand;  ///< strand
+};
+
+/** generate a ring of random rows, rows written are taken from it in turn
+ * @param rows vector to store rows
+ * @param n number of rows to generate
+ */
+void makeRows(std::vector<Row>& rows, size_t n){
+    std::mt19937 rng(1);
+    rows.resize(n);
+    for(auto& r: rows){
+        r.chr = 1 + rng() % 22;
+        r.beg = rng() % 200000000;
+        r.end = r.beg + 100 + rng() % 900;
+        r.score = (rng() % 100000) / 100.0;
+        r.strand = (rng() & 1) ? '+' : '-';
+    }
+}
+
+/** write rows by formatting each row into a new ostringstream and calling writeString
+ * @param fw FileWriter to write rows
+ * @param rows rows to take from in turn
+ * @param n number of rows to write
+ */
+void writeStream(FileWriter& fw, const std::vector<Row>& rows, uint64_t n){
+    for(uint64_t i = 0; i < n; ++i){
+        const Row& r = rows[i % rows.size()];
+        std::ostringstream oss;
+        oss << "chr" << r.chr << "\t" << r.beg << "\t" << r.end << "\trow" << i << "\t";
+        oss << std::fixed << std::setprecision(2) << r.score << "\t" << r.strand << "\n";
+        fw.writeString(oss.str());
+    }
+}
+
+/** write rows by formatting each row into one reused ostringstream and calling writeString
+ * @param fw FileWriter to write rows
+ * @param rows rows to take from in turn
+ * @param n number of rows to write
+ */
+void writeStreamReused(FileWriter& fw, const std::vector<Row>& rows, uint64_t n){
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2);
+    for(uint64_t i = 0; i < n; ++i){
+        const Row& r = rows[i % rows.size()];
+        oss.str("");
+        oss << "chr" << r.chr << "\t" << r.beg << "\t" << r.end << "\trow" << i << "\t";
+        oss << r.score << "\t" << r.strand << "\n";
+        fw.writeString(oss.str());
+    }
+}
+
+/** write rows with the FileWriter append API, fields are formatted into the output buffer directly
+ * @param fw FileWriter to write rows
+ * @param rows rows to take from in turn
+ * @param n number of rows to write
+ */
+void writeAppend(FileWriter& fw, const std::vector<Row>& rows, uint64_t n){
+    for(uint64_t i = 0; i < n; ++i){
+        const Row& r = rows[i % rows.size()];
+        fw.append("chr", 3);
+        fw.appendInt(r.chr);
+        fw.appendChar('\t');
+        fw.appendInt(r.beg);
+        fw.appendChar('\t');
+        fw.appendInt(r.end);
+        fw.append("\trow", 4);
+        fw.appendInt(i);
+        fw.appendChar('\t');
+        fw.appendFloat(r.score, 2);
+        fw.appendChar('\t');
+        fw.appendChar(r.strand);
+        fw.appendChar('\n');
+    }
+}
+
+/** time writing n rows to a file with one method and output a tsv line of result
+ * @param method method name
+ * @param fn output file
+ * @param rows rows to take from in turn
+ * @param n number of rows to write
+ * @param f function writing rows as f(FileWriter&, rows, n)
+ */
+template<typename F>
+void benchWrite(const std::string& method, const std::string& fn, const std::vector<Row>& rows, uint64_t n, F f){
+    auto beg = std::chrono::steady_clock::now();
+    {
+        FileWriter fw(fn);
+        f(fw, rows, n);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - beg).count();
+    struct stat info;
+    uint64_t bytes = stat(fn.c_str(), &info) == 0 ? info.st_size : 0;
+    std::cout << method << "\t" << n << "\t" << bytes << "\t" << seconds << "\t" << n / seconds / 1e6 << std::endl;
+}
+
+int main(int argc, char** argv){
+    uint64_t n = 100000000;
+    std::string out = "/tmp/benchFileWriter." + std::to_string(getpid()) + ".tsv";
+    bool keep = false;
+    for(int i = 1; i < argc; ++i){
+        std::string arg = argv[i];
+        if(arg == "-n" && i + 1 < argc){
+            n = std::max(1LL, std::atoll(argv[++i]));
+        }else if(arg == "-o" && i + 1 < argc){
+            out = argv[++i];
+            keep = true;
+        }else{
+            fprintf(stderr, "Usage: %s [options]\n", argv[0]);
+            fprintf(stderr, "  -n rows     number of TSV rows to write by each method [%lu]\n", (unsigned long)n);
+            fprintf(stderr, "  -o file     output file, end with .gz to write gzip [%s]\n", out.c_str());
+            return 1;
+        }
+    }
+    std::vector<Row> rows;
+    makeRows(rows, 1 << 16);
+    std::cout << "method\trows\tbytes\tseconds\tmillion_rows_per_second" << std::endl;
+    benchWrite("ostringstream", out, rows, n, writeStream);
+    benchWrite("ostringstream_reused", out, rows, n, writeStreamReused);
+    benchWrite("append", out, rows, n, writeAppend);
+    if(!keep){
+        std::remove(out.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,287 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <iostream>
+#include <algorithm>
+#include "util.h"
+
+uint64_t gSink = 0; ///< sum of results to keep benchmarked calls from being optimized away
+
+/** Structure to hold result of one benchmark */
+struct BenchResult{
+    std::string input;           ///< input description
+    std::string method;          ///< method benchmarked
+    uint64_t bytes = 0;          ///< Bytes processed in each run
+    std::vector<double> seconds; ///< seconds used by each run
+};
+
+/** run a function repeatedly and record seconds of each run
+ * @param r BenchResult to store seconds in
+ * @param repeat number of runs
+ * @param f function to run
+ */
+template<typename F>
+void timeRuns(BenchResult& r, int repeat, F f){
+    for(int i = 0; i < repeat; ++i){
+        auto beg = std::chrono::steady_clock::now();
+        f();
+        r.seconds.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - beg).count());
+    }
+}
+
+/** run a function repeatedly and output the best run as a tsv line
+ * @param input input description
+ * @param method method benchmarked
+ * @param bytes Bytes processed in each run
+ * @param repeat number of runs
+ * @param f function to run
+ */
+template<typename F>
+void bench(const std::string& input, const std::string& method, uint64_t bytes, int repeat, F f){
+    BenchResult r;
+    r.input = input;
+    r.method = method;
+    r.bytes = bytes;
+    timeRuns(r, repeat, f);
+    double best = *std::min_element(r.seconds.begin(), r.seconds.end());
+    std::cout << r.input << "\t" << r.method << "\t" << r.bytes << "\t" << best << "\t" << r.bytes / 1048576.0 / best << std::endl;
+}
+
+/** get complement base with a switch, as util::complement did before the lookup table
+ * @param base nucleotide base character
+ * @return the uppercased complementary nucleotide base
+ */
+inline char complementSwitch(char base){
+    switch(base){
+        case 'A': case 'a':
+            return 'T';
+        case 'T': case 't':
+            return 'A';
+        case 'C': case 'c':
+            return 'G';
+        case 'G': case 'g':
+            return 'C';
+        default:
+            return 'N';
+    }
+}
+
+/** reverse complement a sequence with complementSwitch, as util::reverseComplement did before
+ * @param in input sequence
+ * @param out output sequence of len bases
+ * @param len length of the sequence
+ */
+void reverseComplementSwitch(const char* in, char* out, size_t len){
+    for(size_t i = 0; i < len; ++i){
+        out[i] = complementSwitch(in[len - 1 - i]);
+    }
+}
+
+/** reverse complement a sequence in place with complementSwitch, as util::reverseComplement did before
+ * @param seq sequence
+ * @param len length of the sequence
+ */
+void reverseComplementSwitch(char* seq, size_t len){
+    for(size_t i = 0, j = len; i < j--; ++i){
+        char c = complementSwitch(seq[i]);
+        seq[i] = complementSwitch(seq[j]);
+        seq[j] = c;
+    }
+}
+
+/** generate a random nucleotide sequence with soft masked(lowercase) bases and N
+ * @param seq string to store the sequence
+ * @param len length of the sequence
+ */
+void makeSeq(std::string& seq, size_t len){
+    std::mt19937 rng(1);
+    seq.resize(len);
+    for(auto& c: seq){
+        uint32_t r = rng();
+        c = (r % 100) == 0 ? 'N' : "ACGT"[(r >> 8) & 3];
+        if(((r >> 16) % 10) == 0){
+            c = std::tolower(c);
+        }
+    }
+}
+
+/** Structure to hold one complement kernel to benchmark */
+struct ComplementKernel{
+    std::string name;                                           ///< kernel name
+    void (*complement)(const char*, char*, size_t, bool, bool); ///< out of place kernel
+    void (*reverseComplement)(char*, size_t, bool);             ///< in place kernel
+};
+
+/** benchmark reverse complement kernels on a sequence split into pieces of equal length
+ * @param input input description
+ * @param seq input sequence
+ * @param piece length of each piece complemented by one call
+ * @param repeat number of runs
+ */
+void benchComplement(const std::string& input, const std::string& seq, size_t piece, int repeat){
+    std::vector<ComplementKernel> kernels;
+    kernels.push_back({"table", util::complementScalar, util::reverseComplementScalar});
+#ifdef UTIL_X86_SIMD
+    if(__builtin_cpu_supports("ssse3")){
+        kernels.push_back({"ssse3", util::complementSSSE3, util::reverseComplementSSSE3});
+    }
+    if(__builtin_cpu_supports("avx2")){
+        kernels.push_back({"avx2", util::complementAVX2, util::reverseComplementAVX2});
+    }
+#endif
+    size_t len = seq.size() / piece * piece;
+    std::string ref(len, '\0'), out(len, '\0'), buf(seq, 0, len);
+    bench(input, "revcomp_switch", len, repeat, [&]{
+        for(size_t i = 0; i < len; i += piece){
+            reverseComplementSwitch(seq.data() + i, &ref[i], piece);
+        }
+    });
+    bench(input, "revcomp_inplace_switch", len, repeat, [&]{
+        for(size_t i = 0; i < len; i += piece){
+            reverseComplementSwitch(&buf[i], piece);
+        }
+    });
+    for(auto& k: kernels){
+        for(bool iupac: {false, true}){
+            std::string suffix = k.name + (iupac ? "_iupac" : "");
+            bench(input, "revcomp_" + suffix, len, repeat, [&]{
+                for(size_t i = 0; i < len; i += piece){
+                    k.complement(seq.data() + i, &out[i], piece, true, iupac);
+                }
+            });
+            if(!iupac && out != ref){
+                std::cerr << "revcomp_" << suffix << " result differs from revcomp_switch" << std::endl;
+            }
+            bench(input, "revcomp_inplace_" + suffix, len, repeat, [&]{
+                for(size_t i = 0; i < len; i += piece){
+                    k.reverseComplement(&buf[i], piece, iupac);
+                }
+            });
+        }
+    }
+}
+
+/** whether a string starts with some substring, with std::string parameters as util::startsWith did before
+ * @param str string
+ * @param pre prefix
+ * @return true if str starts with pre
+ */
+bool startsWithString(const std::string& str, const std::string& pre){
+    return str.length() >= pre.length() && std::equal(pre.begin(), pre.end(), str.begin());
+}
+
+/** whether a string ends with some substring, with std::string parameters as util::endsWith did before
+ * @param str string
+ * @param suf suffix
+ * @return true if str ends with suf
+ */
+bool endsWithString(const std::string& str, const std::string& suf){
+    return str.length() >= suf.length() && std::equal(suf.rbegin(), suf.rend(), str.rbegin());
+}
+
+/** generate GTF-like lines padded with white spaces and file paths
+ * @param lines vector to store lines
+ * @param paths vector to store paths
+ * @param n number of lines and paths
+ */
+void makeStrings(std::vector<std::string>& lines, std::vector<std::string>& paths, size_t n){
+    std::mt19937 rng(3);
+    lines.resize(n);
+    paths.resize(n);
+    for(size_t i = 0; i < n; ++i){
+        std::string id = std::to_string(rng() % 100000);
+        lines[i] = "  chr" + std::to_string(1 + rng() % 22) + "\tHAVANA\texon\t" + std::to_string(rng() % 200000000) +
+                   "\t.\t+\t.\tgene_id \"ENSG" + id + "\"; transcript_id \"ENST" + id + "\";\t \n";
+        paths[i] = "/data/project/sample" + id + "/align/sample" + id + ".sorted.bam";
+    }
+}
+
+/** benchmark allocating string helpers against their view/out parameter variants
+ * @param n number of lines and paths
+ * @param repeat number of runs
+ */
+void benchString(size_t n, int repeat){
+    std::vector<std::string> lines, paths;
+    makeStrings(lines, paths, n);
+    uint64_t lineBytes = 0, pathBytes = 0;
+    for(size_t i = 0; i < n; ++i){
+        lineBytes += lines[i].size();
+        pathBytes += paths[i].size();
+    }
+    std::string out;
+    std::string input = "lines_" + std::to_string(n);
+    bench(input, "strip", lineBytes, repeat, [&]{for(auto& l: lines) gSink += util::strip(l).size();});
+    bench(input, "stripView", lineBytes, repeat, [&]{for(auto& l: lines) gSink += util::stripView(l).size();});
+    bench(input, "lstrip", lineBytes, repeat, [&]{for(auto& l: lines) gSink += util::lstrip(l).size();});
+    bench(input, "lstripView", lineBytes, repeat, [&]{for(auto& l: lines) gSink += util::lstripView(l).size();});
+    bench(input, "rstrip", lineBytes, repeat, [&]{for(auto& l: lines) gSink += util::rstrip(l).size();});
+    bench(input, "rstripView", lineBytes, repeat, [&]{for(auto& l: lines) gSink += util::rstripView(l).size();});
+    bench(input, "replace", lineBytes, repeat, [&]{for(auto& l: lines) gSink += util::replace(l, "\"", "").size();});
+    bench(input, "replace_out", lineBytes, repeat, [&]{
+        for(auto& l: lines){
+            util::replace(l, "\"", "", out);
+            gSink += out.size();
+        }
+    });
+    bench(input, "getAlpha", lineBytes, repeat, [&]{for(auto& l: lines) gSink += util::getAlpha(l).size();});
+    bench(input, "getAlpha_out", lineBytes, repeat, [&]{
+        for(auto& l: lines){
+            util::getAlpha(l, out);
+            gSink += out.size();
+        }
+    });
+    bench(input, "startsWith_string", lineBytes, repeat, [&]{for(auto& l: lines) gSink += startsWithString(l, "  chr1\tHAVANA");});
+    bench(input, "startsWith", lineBytes, repeat, [&]{for(auto& l: lines) gSink += util::startsWith(l, "  chr1\tHAVANA");});
+    bench(input, "endsWith_string", lineBytes, repeat, [&]{for(auto& l: lines) gSink += endsWithString(l, "\";\t \n");});
+    bench(input, "endsWith", lineBytes, repeat, [&]{for(auto& l: lines) gSink += util::endsWith(l, "\";\t \n");});
+    input = "paths_" + std::to_string(n);
+    bench(input, "basename", pathBytes, repeat, [&]{for(auto& p: paths) gSink += util::basename(p).size();});
+    bench(input, "basenameView", pathBytes, repeat, [&]{for(auto& p: paths) gSink += util::basenameView(p).size();});
+    bench(input, "dirname", pathBytes, repeat, [&]{for(auto& p: paths) gSink += util::dirname(p).size();});
+    bench(input, "dirnameView", pathBytes, repeat, [&]{for(auto& p: paths) gSink += util::dirnameView(p).size();});
+}
+
+int main(int argc, char** argv){
+    size_t reads = 1000000;
+    size_t contigMbp = 100;
+    size_t strings = 1000000;
+    int repeat = 3;
+    std::string test = "all";
+    for(int i = 1; i < argc; ++i){
+        std::string arg = argv[i];
+        if(arg == "-n" && i + 1 < argc){
+            reads = std::max(1, std::atoi(argv[++i]));
+        }else if(arg == "-l" && i + 1 < argc){
+            contigMbp = std::max(1, std::atoi(argv[++i]));
+        }else if(arg == "-s" && i + 1 < argc){
+            strings = std::max(1, std::atoi(argv[++i]));
+        }else if(arg == "-t" && i + 1 < argc){
+            test = argv[++i];
+        }else if(arg == "-r" && i + 1 < argc){
+            repeat = std::max(1, std::atoi(argv[++i]));
+        }else{
+            fprintf(stderr, "Usage: %s [options]\n", argv[0]);
+            fprintf(stderr, "  -n reads    number of 100bp reads to complement [%lu]\n", (unsigned long)reads);
+            fprintf(stderr, "  -l length   Mbp of contig to complement [%lu]\n", (unsigned long)contigMbp);
+            fprintf(stderr, "  -s strings  number of lines and paths to run string helpers on [%lu]\n", (unsigned long)strings);
+            fprintf(stderr, "  -t test     benchmark to run, complement, string or all [%s]\n", test.c_str());
+            fprintf(stderr, "  -r repeat   number of runs of each method [%d]\n", repeat);
+            return 1;
+        }
+    }
+    std::cout << "input\tmethod\tbytes\tbest_seconds\tmb_per_second" << std::endl;
+    if(test == "all" || test == "complement"){
+        std::string seq;
+        makeSeq(seq, reads * 100);
+        benchComplement("read_100bp", seq, 100, repeat);
+        makeSeq(seq, contigMbp * 1000000);
+        benchComplement("contig_" + std::to_string(contigMbp) + "Mbp", seq, seq.size(), repeat);
+    }
+    if(test == "all" || test == "string"){
+        benchString(strings, repeat);
+    }
+    std::cerr << "checksum: " << gSink << std::endl;
+    return 0;
+}
@@ -7,6 +7,77 @@
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <sys/stat.h>
+#include "util.h"
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#define FILEREADER_MMAP
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define FILEREADER_X86_SIMD
+#endif
+
+/** Class to hold a pool of equal sized read buffers to be shared and recycled by many FileReaders */
+class ReadBufferPool{
+    int32_t mBufSize;          ///< size of each buffer
+    std::vector<char*> mFree;  ///< buffers released and ready to be reused
+    std::mutex mMtx;           ///< mutex to guard mFree
+
+    public:
+    /** Construct a ReadBufferPool
+     * @param bufSize size of each buffer
+     */
+    ReadBufferPool(int32_t bufSize = (1 << 20)){
+        mBufSize = bufSize;
+    }
+
+    /** ReadBufferPool Destructor, all FileReaders using this pool must be destroyed before */
+    ~ReadBufferPool(){
+        for(auto& p: mFree){
+            delete[] p;
+        }
+    }
+
+    /** get size of each buffer
+     * @return size of each buffer
+     */
+    inline int32_t getBufSize(){
+        return mBufSize;
+    }
+
+    /** get a buffer from the pool, allocate a new one if no buffer released
+     * @return pointer to a buffer of getBufSize() Bytes
+     */
+    inline char* acquire(){
+        std::lock_guard<std::mutex> l(mMtx);
+        if(mFree.empty()){
+            return new char[mBufSize];
+        }
+        char* p = mFree.back();
+        mFree.pop_back();
+        return p;
+    }
+
+    /** return a buffer to the pool
+     * @param p pointer to buffer got from acquire()
+     */
+    inline void release(char* p){
+        if(p){
+            std::lock_guard<std::mutex> l(mMtx);
+            mFree.push_back(p);
+        }
+    }
+};
 
 /** Class to hold a file reader in the format .gz or plain text */
 class FileReader{
@@ -14,35 +85,129 @@ class FileReader{
     gzFile mGzipFile;       ///< gzFile to store opened mZipped file handler
     FILE* mFile;            ///< FILE pointer to store opened plain file handler
     bool mZipped;           ///< the file is gzipped if true
-    char* mBuf;             ///< mBuffer to store a chunk of characters read from mGzipFile or mFile
-    int mBufDataLen;        ///< the length of characters read into the mBuffer after the last read
-    int mBufUsedLen;        ///< the length of characters already consumed in the mBuffer 
+    char* mBuf;             ///< mBuffer to store a chunk of characters read from mGzipFile or mFile, or the whole mapped file
+    int64_t mBufDataLen;    ///< the length of characters read into the mBuffer after the last read
+    int64_t mBufUsedLen;    ///< the length of characters already consumed in the mBuffer 
+    bool mMapped;           ///< the plain file is memory mapped into mBuf if true
     bool mStdinMode;        ///< read from stdin if true
     bool mNoLineBreakAtEnd; ///< the file has no '\n' as a line break at the last line if true
     int32_t mReadBufSize;   ///< the mBuffer size used to read
+    ReadBufferPool* mPool;  ///< pool to get mBuf and mBackBuf from, allocate them if NULL
+    std::string mLineBuf;   ///< spill buffer to store a line straddling two mBuf reads
+    bool mSkipLF;           ///< skip a leading '\n' in next mBuf if last line ended with '\r'
+    bool mAsyncRead;        ///< read(inflate) next chunk in a background thread if true
+    char* mBackBuf;         ///< buffer filled by background thread while mBuf is being consumed
+    int mBackDataLen;       ///< the length of characters read into mBackBuf
+    bool mBackReady;        ///< mBackBuf is filled and ready to be swapped with mBuf
+    bool mBackLast;         ///< mBackBuf holds the last chunk of the file
+    bool mAsyncEof;         ///< the last chunk has been swapped into mBuf
+    bool mAsyncStop;        ///< background thread should stop if true
+    std::thread mAsyncThread;           ///< background reading thread
+    std::mutex mAsyncMtx;               ///< mutex to guard mBackBuf status
+    std::condition_variable mAsyncCond; ///< condition variable to notify mBackBuf status change
+
+    /** Structure to hold one BGZF block being inflated */
+    struct BgzfSlot{
+        std::vector<char> raw; ///< compressed block read from file
+        std::vector<char> out; ///< inflated data of this block
+        int outLen = 0;        ///< length of inflated data, -1 if error occurs
+        bool ready = false;    ///< inflated and ready to be consumed
+        bool last = false;     ///< no more block after this one(end of file or error)
+    };
+
+    int mThreads;                         ///< number of threads to inflate BGZF blocks
+    bool mBgzf;                           ///< inflate BGZF blocks in parallel if true
+    std::vector<BgzfSlot> mBgzfSlots;     ///< ring of blocks being inflated, block i is stored in slot i % size
+    std::vector<std::thread> mBgzfWorkers;///< threads to inflate BGZF blocks
+    uint64_t mBgzfNextRead;               ///< index of next block to be read from file
+    uint64_t mBgzfNextUse;                ///< index of next block to be consumed
+    int mBgzfUsedLen;                     ///< length of inflated data already consumed in current block
+    bool mBgzfReadEnd;                    ///< all blocks have been read from file
+    bool mBgzfEof;                        ///< the last block has been consumed
+    bool mBgzfStop;                       ///< BGZF inflating threads should stop if true
+    std::mutex mBgzfMtx;                  ///< mutex to guard mBgzfSlots status and file reading
+    std::condition_variable mBgzfCond;    ///< condition variable to notify mBgzfSlots status change
+    size_t mBgzfBytesRead;                ///< Bytes of BGZF blocks read from file
+
+    size_t mTotalBytes;                   ///< total Bytes of the file, cached at init, 0 if unknown(stdin or pipe)
+    int64_t mChunkBase;                   ///< uncompressed offset of the first character in mBuf
+    std::chrono::steady_clock::time_point mStartTime; ///< time when the file was opened
+    std::atomic<size_t> mBytesRead;       ///< Bytes read from file(compressed Bytes for gz file)
+    std::atomic<size_t> mBytesInflated;   ///< uncompressed Bytes read(inflated) from file
+    std::atomic<size_t> mBytesConsumed;   ///< uncompressed Bytes consumed by getline, line breaks included
+    std::atomic<size_t> mLines;           ///< number of lines emitted by getline
     
     public:
+    /** Structure to hold a snapshot of reading progress, see getProgress() */
+    struct Progress{
+        size_t bytesRead;     ///< Bytes read from file(compressed Bytes for gz file)
+        size_t bytesTotal;    ///< total Bytes of file, 0 if unknown(stdin or pipe)
+        size_t bytesInflated; ///< uncompressed Bytes read(inflated) from file
+        size_t bytesConsumed; ///< uncompressed Bytes consumed by getline
+        size_t lines;         ///< number of lines emitted by getline
+        double seconds;       ///< seconds elapsed since the file was opened
+        double speed;         ///< MB of file read per second
+        double eta;           ///< estimated seconds remaining, -1 if unknown
+        double ratio;         ///< compression ratio(bytesInflated/bytesRead), 1 for plain file
+    };
+
     /** Construct a file reader with filename
      * @param filename Name of the file
+     * @param asyncRead read(inflate) next chunk in a background thread while current chunk is being parsed if true
+     * @param threads number of threads to inflate a BGZF file, a BGZF file is inflated in parallel if threads > 1
+     * @param bufSize size of each read from file, ignored if pool provided
+     * @param pool pool to get read buffers from and return them to on destruction, buffers are allocated if NULL
      */
-    FileReader(const std::string& filename){
+    FileReader(const std::string& filename, bool asyncRead = false, int threads = 1, int32_t bufSize = (1 << 20), ReadBufferPool* pool = NULL){
         mFileName = filename;
         mGzipFile = NULL;
         mFile = NULL;
         mStdinMode = false;
-        mReadBufSize = (1 << 20);
-        mBuf = new char[mReadBufSize];
+        mPool = pool;
+        mReadBufSize = mPool ? mPool->getBufSize() : bufSize;
+        mBuf = nullptr;
+        mMapped = false;
         mBufDataLen = 0;
         mBufUsedLen = 0;
         mNoLineBreakAtEnd = false;
+        mSkipLF = false;
+        mAsyncRead = asyncRead;
+        mBackBuf = nullptr;
+        mBackDataLen = 0;
+        mBackReady = false;
+        mBackLast = false;
+        mAsyncEof = false;
+        mAsyncStop = false;
+        mThreads = threads;
+        mBgzf = false;
+        mBgzfNextRead = 0;
+        mBgzfNextUse = 0;
+        mBgzfUsedLen = 0;
+        mBgzfReadEnd = false;
+        mBgzfEof = false;
+        mBgzfStop = false;
+        mBgzfBytesRead = 0;
+        mTotalBytes = 0;
+        mChunkBase = 0;
+        mBytesRead = 0;
+        mBytesInflated = 0;
+        mBytesConsumed = 0;
+        mLines = 0;
         init();
     }
     
     /** FileReader Destructor */
     ~FileReader(){
         close();
-        delete mBuf;
+        if(mPool){
+            mPool->release(mBuf);
+            mPool->release(mBackBuf);
+        }else{
+            delete[] mBuf;
+            delete[] mBackBuf;
+        }
         mBuf = nullptr;
+        mBackBuf = nullptr;
     }
    
     /** Tell whether the file is zipped or not
@@ -56,15 +221,33 @@ class FileReader{
      *  Get the total number of Bytes in the file, store it in bytesTotal
      */
     inline void getBytes(size_t& bytesRead, size_t& bytesTotal){
-        if(mZipped){
-            bytesRead = gzoffset(mGzipFile);
+        bytesRead = mMapped ? mBytesConsumed.load(std::memory_order_relaxed) : mBytesRead.load(std::memory_order_relaxed);
+        bytesTotal = mTotalBytes;
+    }
+
+    /** Get a snapshot of reading progress, only counters updated by the reading thread are loaded,\n
+     * so it is cheap and safe to be polled from another thread during reading
+     * @return Progress of this reader
+     */
+    inline Progress getProgress(){
+        Progress p;
+        p.bytesTotal = mTotalBytes;
+        p.bytesConsumed = mBytesConsumed.load(std::memory_order_relaxed);
+        p.lines = mLines.load(std::memory_order_relaxed);
+        if(mMapped){
+            p.bytesRead = p.bytesInflated = p.bytesConsumed;
         }else{
-            bytesRead = std::ftell(mFile);
+            p.bytesRead = mBytesRead.load(std::memory_order_relaxed);
+            p.bytesInflated = mBytesInflated.load(std::memory_order_relaxed);
+        }
+        p.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - mStartTime).count();
+        p.speed = p.seconds > 0 ? p.bytesRead / p.seconds / (1 << 20) : 0;
+        p.eta = -1;
+        if(p.bytesTotal > 0 && p.bytesRead > 0){
+            p.eta = p.seconds * (p.bytesTotal - std::min(p.bytesRead, p.bytesTotal)) / p.bytesRead;
         }
-        // use another ifstream without affecting the current reader
-        std::ifstream is(mFileName);
-        is.seekg(0, is.end);
-        bytesTotal = is.tellg();
+        p.ratio = p.bytesRead > 0 ? double(p.bytesInflated) / p.bytesRead : 1;
+        return p;
     }
 
     /** tell whether the file is a zipped file
@@ -80,80 +263,240 @@ class FileReader{
         }
         return false;
     }
+
+    /** tell whether the file is in BGZF format(blocked gzip, as produced by bgzip)
+     * @param filename file name
+     * @return true if the first block header of the file is a BGZF block header
+     */
+    inline static bool isBgzfFile(const std::string& filename){
+        FILE* fp = std::fopen(filename.c_str(), "rb");
+        if(fp == NULL){
+            return false;
+        }
+        std::vector<unsigned char> h(12 + 65535);
+        size_t len = std::fread(h.data(), 1, h.size(), fp);
+        std::fclose(fp);
+        return getBgzfBlockSize(h.data(), len) > 0;
+    }
     
     /** read one line into line from buffer
      * @param line strin to store result
      * @return true if read successful
      */
     inline bool getline(std::string& line){
-        if(mBufUsedLen >= mBufDataLen && eof()){
+        std::string_view view;
+        if(!getline(view)){
+            return false;
+        }
+        line.assign(view.data(), view.size());
+        return true;
+    }
+
+    /** read one line as a view without copying, line breaks not included\n
+     * the view points into mBuf directly, only a line straddling two reads is copied into mLineBuf\n
+     * the view is invalidated by the next call of getline
+     * @param line string_view to store result
+     * @return true if read successful
+     */
+    inline bool getline(std::string_view& line){
+        if(mGzipFile == NULL && mFile == NULL){
             return false;
         }
-        if(mZipped && mGzipFile == NULL){
+        if(mBufUsedLen >= mBufDataLen && !fillBuf()){
             return false;
         }
-        line = getlineFromBuffer();
+        const char* start = mBuf + mBufUsedLen;
+        const char* bufEnd = mBuf + mBufDataLen;
+        const char* end = findLineBreak(start, bufEnd);
+        // line well contained in this mBuf
+        if(end < bufEnd){
+            line = std::string_view(start, end - start);
+            consumeLineBreak(end);
+            countLine();
+            return true;
+        }
+        // line not contained in this mBuf, spill it and read new mBuf until a line break found
+        mLineBuf.assign(start, end - start);
+        mBufUsedLen = mBufDataLen;
+        while(fillBuf()){
+            start = mBuf + mBufUsedLen;
+            bufEnd = mBuf + mBufDataLen;
+            end = findLineBreak(start, bufEnd);
+            mLineBuf.append(start, end - start);
+            if(end < bufEnd){
+                consumeLineBreak(end);
+                break;
+            }
+            mBufUsedLen = mBufDataLen;
+        }
+        line = std::string_view(mLineBuf);
+        countLine();
         return true;
     }
 
-private:
-    /** get just one line from the mBuf, update the mBuf if needed
-     */
-    inline std::string getlineFromBuffer(){
-        int start = mBufUsedLen;
-        int end = start;
-        // look for '\r' or '\n' until the end of mBuf
-        while(end < mBufDataLen){
-            if(mBuf[end] != '\r' && mBuf[end] != '\n'){
-                ++end;
-            }else{
+    /** read whole lines into chunk until at least size Bytes read or end of file reached, line breaks are kept\n
+     * lines read in this way are not counted into Progress::lines
+     * @param chunk string to store lines, cleared first
+     * @param size minimum Bytes of lines to read
+     * @return true if any line read
+     */
+    inline bool getChunk(std::string& chunk, size_t size){
+        chunk.clear();
+        if(mGzipFile == NULL && mFile == NULL){
+            return false;
+        }
+        while(mBufUsedLen < mBufDataLen || fillBuf()){
+            const char* start = mBuf + mBufUsedLen;
+            const char* bufEnd = mBuf + mBufDataLen;
+            size_t need = chunk.size() < size ? size - chunk.size() : 0;
+            if(need == 0 && !chunk.empty() && chunk.back() == '\n'){
                 break;
             }
+            const char* end = bufEnd;
+            if((size_t)(bufEnd - start) > need){
+                end = findLineBreak(start + need, bufEnd);
+            }
+            if(end < bufEnd){
+                consumeLineBreak(end);
+                chunk.append(start, mBuf + mBufUsedLen - start);
+                break;
+            }
+            chunk.append(start, bufEnd - start);
+            mBufUsedLen = mBufDataLen;
         }
-        // if '\r' or '\n' found(this line well contained in this mBuf)
-        // or this is the last mBuf of file
-        if(end < mBufDataLen || mBufDataLen < mReadBufSize){
-            int len = end - start;
-            std::string line(mBuf + start, len);
-            ++end;
-            if(end < mBufDataLen - 1 && mBuf[end - 1] == '\r' && mBuf[end] == '\n'){
-                ++end;
+        mBytesConsumed.store(mChunkBase + mBufUsedLen, std::memory_order_relaxed);
+        return !chunk.empty();
+    }
+
+    /** pointer type of a function to find the first line break in range [beg, end) */
+    typedef const char* (*LineBreakFinder)(const char* beg, const char* end);
+
+    /** find the first '\r' or '\n' in range [beg, end), the fastest kernel supported by cpu is selected at first call
+     * @param beg pointer to the first character
+     * @param end pointer past the last character
+     * @return pointer to the first line break character, or end if not found
+     */
+    inline static const char* findLineBreak(const char* beg, const char* end){
+        static const LineBreakFinder finder = selectLineBreakFinder();
+        return finder(beg, end);
+    }
+
+private:
+    /** update line and Bytes consumed counters after a line emitted, only the reading thread writes them,\n
+     * so plain relaxed stores are used instead of atomic read-modify-write
+     */
+    inline void countLine(){
+        mLines.store(mLines.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        mBytesConsumed.store(mChunkBase + mBufUsedLen, std::memory_order_relaxed);
+    }
+
+    /** select the fastest line break finding kernel supported by cpu at runtime, SSE2 is part of the x86-64 baseline\n
+     * so it is used unless util::getSimdLevel reports AVX2
+     * @return pointer to line break finding function
+     */
+    inline static LineBreakFinder selectLineBreakFinder(){
+#ifdef FILEREADER_X86_SIMD
+        if(util::getSimdLevel() == 2){
+            return findLineBreakAVX2;
+        }
+#ifdef __SSE2__
+        return findLineBreakSSE2;
+#endif
+#endif
+        return findLineBreakScalar;
+    }
+
+    /** find the first '\r' or '\n' in range [beg, end) one character at a time
+     * @param beg pointer to the first character
+     * @param end pointer past the last character
+     * @return pointer to the first line break character, or end if not found
+     */
+    inline static const char* findLineBreakScalar(const char* beg, const char* end){
+        while(beg < end && *beg != '\r' && *beg != '\n'){
+            ++beg;
+        }
+        return beg;
+    }
+
+#ifdef FILEREADER_X86_SIMD
+    /** find the first '\r' or '\n' in range [beg, end) 16 characters at a time
+     * @param beg pointer to the first character
+     * @param end pointer past the last character
+     * @return pointer to the first line break character, or end if not found
+     */
+    __attribute__((target("sse2")))
+    inline static const char* findLineBreakSSE2(const char* beg, const char* end){
+        const __m128i cr = _mm_set1_epi8('\r');
+        const __m128i lf = _mm_set1_epi8('\n');
+        while(end - beg >= 16){
+            __m128i v = _mm_loadu_si128((const __m128i*)beg);
+            int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, cr), _mm_cmpeq_epi8(v, lf)));
+            if(mask){
+                return beg + __builtin_ctz(mask);
             }
-            mBufUsedLen = end;
-            return line;
+            beg += 16;
         }
-        // if '\r' or '\n' not found && this is not the last mBuf of file
-        // then this line is not contained in this mBuf, we should read new mBuf
-        std::string str(mBuf + start, mBufDataLen - start);
-        while(true){
-            readToBuf();
-            start = 0;
-            end = 0;
-            // look for '\r' or '\n' until the end of mBuf
-            while(end < mBufDataLen){
-                if(mBuf[end] != '\r' && mBuf[end] != '\n'){
-                    ++end;
-                }else{
-                    break;
+        return findLineBreakScalar(beg, end);
+    }
+
+    /** find the first '\r' or '\n' in range [beg, end) 32 characters at a time
+     * @param beg pointer to the first character
+     * @param end pointer past the last character
+     * @return pointer to the first line break character, or end if not found
+     */
+    __attribute__((target("avx2")))
+    inline static const char* findLineBreakAVX2(const char* beg, const char* end){
+        const __m256i cr = _mm256_set1_epi8('\r');
+        const __m256i lf = _mm256_set1_epi8('\n');
+        while(end - beg >= 32){
+            __m256i v = _mm256_loadu_si256((const __m256i*)beg);
+            uint32_t mask = _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, cr), _mm256_cmpeq_epi8(v, lf)));
+            if(mask){
+                return beg + __builtin_ctz(mask);
+            }
+            beg += 32;
+        }
+        return findLineBreakSSE2(beg, end);
+    }
+#endif
+
+    /** mark the line break at pos consumed, a "\r\n" pair is consumed as one line break
+     * @param pos pointer to the line break character in mBuf
+     */
+    inline void consumeLineBreak(const char* pos){
+        mBufUsedLen = pos - mBuf + 1;
+        mSkipLF = false;
+        if(*pos == '\r'){
+            if(mBufUsedLen < mBufDataLen){
+                if(mBuf[mBufUsedLen] == '\n'){
+                    ++mBufUsedLen;
                 }
+            }else{
+                mSkipLF = true;
             }
-            // if '\r' or '\n' found(this line well contained in this mBuf)
-            // or this is the last mBuf of file
-            if(end < mBufDataLen || mBufDataLen < mReadBufSize){
-                int len = end - start;
-                str.append(mBuf + start, len);
-                ++end;
-                if(end < mBufDataLen - 1 && mBuf[end - 1] == '\r' && mBuf[end] == '\n'){
-                    ++end;
+        }
+    }
+
+    /** read next chunk into mBuf if mBuf exhausted
+     * @return true if there are unconsumed characters in mBuf
+     */
+    inline bool fillBuf(){
+        while(mBufUsedLen >= mBufDataLen){
+            if(eof()){
+                return false;
+            }
+            readToBuf();
+            if(mBufDataLen <= 0){
+                return false;
+            }
+            if(mSkipLF){
+                mSkipLF = false;
+                if(mBuf[0] == '\n'){
+                    mBufUsedLen = 1;
                 }
-                mBufUsedLen = end;
-                return str;
             }
-            // if '\r' or '\n' not found && this is not the last mBuf of file
-            // then this line is not contained in this mBuf, we should read new mBuf
-            str.append(mBuf + start, mBufDataLen);
         }
-        return std::string();
+        return true;
     }
     
     /** Tell whether the file has no '\n' as a line break at the last line
@@ -167,6 +510,15 @@ private:
      * @return true if eof reached
      */
     inline bool eof(){
+        if(mMapped){
+            return true;
+        }
+        if(mAsyncRead){
+            return mAsyncEof;
+        }
+        if(mBgzf){
+            return mBgzfEof;
+        }
         if(mZipped){
             return gzeof(mGzipFile);
         }else{
@@ -177,14 +529,35 @@ private:
     /** initialize the FileReader:
      * 1, open file and store file handler into mGzipFile or mFile or read from stdin
      * 2, set the starting position for the next read on compressed file stream file to the beginning of file 
-     * 3, update the file format mZipped
-     * 4, call readToBuf() to try to fill the mBuf from first reading
+     * 3, update the file format mZipped, start BGZF inflating threads if BGZF file and mThreads > 1
+     * 4, map a regular plain file into mBuf directly if possible, or else allocate mBuf
+     * 5, start background reading thread if in async mode
+     * 6, call readToBuf() to try to fill the mBuf from first reading
      */ 
     inline void init(){
+        mStartTime = std::chrono::steady_clock::now();
+        struct stat info;
+        if(stat(mFileName.c_str(), &info) == 0 && S_ISREG(info.st_mode)){
+            mTotalBytes = info.st_size;
+        }
         if(isZippedFile(mFileName)){
-            mGzipFile = gzopen(mFileName.c_str(), "r");
             mZipped = true;
-            gzrewind(mGzipFile);
+            if(mThreads > 1 && isBgzfFile(mFileName)){
+                mFile = std::fopen(mFileName.c_str(), "rb");
+                if(mFile == NULL){
+                    std::cerr << "Failed to open file: " <<  mFileName << std::endl;
+                    std::exit(1);
+                }
+                mBgzf = true;
+                mBgzfSlots.resize(mThreads * 4);
+                for(int i = 0; i < mThreads; ++i){
+                    mBgzfWorkers.push_back(std::thread(&FileReader::bgzfInflateLoop, this));
+                }
+            }else{
+                mGzipFile = gzopen(mFileName.c_str(), "r");
+                gzbuffer(mGzipFile, mReadBufSize);
+                gzrewind(mGzipFile);
+            }
         }else{
             if(mFileName == "/dev/stdin"){
                 mFile = stdin;
@@ -196,15 +569,90 @@ private:
                 std::exit(1);
             }
             mZipped = false;
+            if(mapFile()){
+                return;
+            }
+        }
+        mBuf = allocBuf();
+        if(mAsyncRead){
+            mBackBuf = allocBuf();
+            mAsyncThread = std::thread(&FileReader::asyncReadLoop, this);
         }
         readToBuf();
     }
+
+    /** get a read buffer of mReadBufSize Bytes from mPool or allocate a new one
+     * @return pointer to read buffer
+     */
+    inline char* allocBuf(){
+        return mPool ? mPool->acquire() : new char[mReadBufSize];
+    }
+
+    /** map the opened plain file into mBuf if it is a non-empty regular file(not stdin or pipe)\n
+     * the whole mapping is served as one chunk so no line is ever copied
+     * @return true if mapped successfully
+     */
+    inline bool mapFile(){
+#ifdef FILEREADER_MMAP
+        struct stat info;
+        int fd = fileno(mFile);
+        if(fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size <= 0){
+            return false;
+        }
+        void* addr = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(addr == MAP_FAILED){
+            return false;
+        }
+        madvise(addr, info.st_size, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+        madvise(addr, info.st_size, MADV_HUGEPAGE);
+#endif
+        mBuf = (char*)addr;
+        mBufDataLen = info.st_size;
+        mBufUsedLen = 0;
+        mMapped = true;
+        mAsyncRead = false;
+        mNoLineBreakAtEnd = mBuf[mBufDataLen - 1] != '\n';
+        return true;
+#else
+        return false;
+#endif
+    }
     
     /** close the FileReader:
-     * 1, close file handler
-     * 2, set file handler to NULL
+     * 1, stop background reading thread if in async mode
+     * 2, stop BGZF inflating threads if in BGZF mode
+     * 3, unmap mBuf if in mapped mode
+     * 4, close file handler
+     * 5, set file handler to NULL
      */
     inline void close(){
+        if(mAsyncThread.joinable()){
+            {
+                std::lock_guard<std::mutex> l(mAsyncMtx);
+                mAsyncStop = true;
+            }
+            mAsyncCond.notify_all();
+            mAsyncThread.join();
+        }
+        if(!mBgzfWorkers.empty()){
+            {
+                std::lock_guard<std::mutex> l(mBgzfMtx);
+                mBgzfStop = true;
+            }
+            mBgzfCond.notify_all();
+            for(auto& t: mBgzfWorkers){
+                t.join();
+            }
+            mBgzfWorkers.clear();
+        }
+#ifdef FILEREADER_MMAP
+        if(mMapped){
+            munmap(mBuf, mBufDataLen);
+            mBuf = nullptr;
+            mMapped = false;
+        }
+#endif
         if(mZipped && mGzipFile){
             gzclose(mGzipFile);
             mGzipFile = NULL;
@@ -235,22 +683,240 @@ private:
      * if read the last line(mBuf is not filled), update mNoLineBreakAtEnd
      */
    inline void readToBuf(){
-        if(isZipped()){
-            mBufDataLen = gzread(mGzipFile, mBuf, mReadBufSize);
-            if(mBufDataLen == -1){
-                std::cerr << "Error to read gzip file" << std::endl;
-                std::exit(1);
-            }
+        mChunkBase += mBufDataLen;
+        if(mAsyncRead){
+            swapBackBuf();
         }else{
-            mBufDataLen = std::fread(mBuf, 1, mReadBufSize, mFile);
+            mBufDataLen = readChunk(mBuf);
+        }
+        if(mBufDataLen == -1){
+            std::cerr << "Error to read gzip file" << std::endl;
+            std::exit(1);
         }
         mBufUsedLen = 0;
         if(mBufDataLen < mReadBufSize){
-            if(mBuf[mBufDataLen - 1] != '\n'){
+            if(mBufDataLen > 0 && mBuf[mBufDataLen - 1] != '\n'){
                 mNoLineBreakAtEnd = true;
             }
         }
     }
+
+    /** read at most mReadBufSize characters from file into buf
+     * @param buf buffer to store characters read
+     * @return number of characters read, -1 if error occurs
+     */
+    inline int readChunk(char* buf){
+        int len = 0;
+        if(mBgzf){
+            len = readBgzfChunk(buf);
+        }else if(mZipped){
+            len = gzread(mGzipFile, buf, mReadBufSize);
+            mBytesRead.store(gzoffset(mGzipFile), std::memory_order_relaxed);
+        }else{
+            len = std::fread(buf, 1, mReadBufSize, mFile);
+            mBytesRead.store(mBytesRead.load(std::memory_order_relaxed) + len, std::memory_order_relaxed);
+        }
+        if(len > 0){
+            mBytesInflated.store(mBytesInflated.load(std::memory_order_relaxed) + len, std::memory_order_relaxed);
+        }
+        return len;
+    }
+
+    /** wait until mBackBuf filled by background thread and swap it with mBuf,
+     * then wake up background thread to fill the next chunk
+     */
+    inline void swapBackBuf(){
+        std::unique_lock<std::mutex> l(mAsyncMtx);
+        if(mAsyncEof){
+            mBufDataLen = 0;
+            return;
+        }
+        mAsyncCond.wait(l, [this]{return mBackReady;});
+        std::swap(mBuf, mBackBuf);
+        mBufDataLen = mBackDataLen;
+        mAsyncEof = mBackLast;
+        mBackReady = false;
+        l.unlock();
+        mAsyncCond.notify_all();
+    }
+
+    /** background thread routine, fill mBackBuf whenever it has been swapped out until the last chunk read */
+    inline void asyncReadLoop(){
+        std::unique_lock<std::mutex> l(mAsyncMtx);
+        while(true){
+            mAsyncCond.wait(l, [this]{return !mBackReady || mAsyncStop;});
+            if(mAsyncStop){
+                break;
+            }
+            l.unlock();
+            int len = readChunk(mBackBuf);
+            l.lock();
+            mBackDataLen = len;
+            mBackLast = len < mReadBufSize;
+            mBackReady = true;
+            mAsyncCond.notify_all();
+            if(mBackLast){
+                break;
+            }
+        }
+    }
+
+    /** get the total block size from a BGZF block header, the extra field is walked to find the 'BC' subfield
+     * @param h pointer to the header
+     * @param len length of bytes available in h, the whole extra field(12 + XLEN bytes) must be included
+     * @return total block size(BSIZE + 1), -1 if h is not a gzip member header with a 'BC' extra subfield
+     */
+    inline static int getBgzfBlockSize(const unsigned char* h, size_t len){
+        if(len < 12 || h[0] != 31 || h[1] != 139 || h[2] != 8 || !(h[3] & 4)){
+            return -1;
+        }
+        size_t xend = 12 + (h[10] | (h[11] << 8));
+        if(len < xend){
+            return -1;
+        }
+        for(size_t p = 12; p + 4 <= xend;){
+            size_t slen = h[p + 2] | (h[p + 3] << 8);
+            if(h[p] == 'B' && h[p + 1] == 'C' && slen == 2 && p + 6 <= xend){
+                return (h[p + 4] | (h[p + 5] << 8)) + 1;
+            }
+            p += 4 + slen;
+        }
+        return -1;
+    }
+
+    /** copy inflated BGZF blocks into buf in order, wait for blocks not inflated yet
+     * @param buf buffer to store characters inflated
+     * @return number of characters stored in buf, -1 if error occurs
+     */
+    inline int readBgzfChunk(char* buf){
+        int filled = 0;
+        while(filled < mReadBufSize && !mBgzfEof){
+            BgzfSlot& slot = mBgzfSlots[mBgzfNextUse % mBgzfSlots.size()];
+            std::unique_lock<std::mutex> l(mBgzfMtx);
+            mBgzfCond.wait(l, [&slot]{return slot.ready;});
+            l.unlock();
+            if(slot.outLen < 0){
+                return -1;
+            }
+            int len = std::min(slot.outLen - mBgzfUsedLen, mReadBufSize - filled);
+            if(len){
+                std::memcpy(buf + filled, slot.out.data() + mBgzfUsedLen, len);
+            }
+            filled += len;
+            mBgzfUsedLen += len;
+            if(mBgzfUsedLen == slot.outLen){
+                mBgzfEof = slot.last;
+                mBgzfUsedLen = 0;
+                l.lock();
+                slot.ready = false;
+                ++mBgzfNextUse;
+                l.unlock();
+                mBgzfCond.notify_all();
+            }
+        }
+        return filled;
+    }
+
+    /** read next BGZF block from mFile into slot.raw
+     * @param slot BgzfSlot to store the compressed block
+     * @return compressed block size, 0 if end of file, -1 if error occurs
+     */
+    inline int readBgzfBlock(BgzfSlot& slot){
+        slot.raw.resize(65536);
+        unsigned char* h = (unsigned char*)slot.raw.data();
+        size_t len = std::fread(h, 1, 12, mFile);
+        if(len == 0){
+            return 0;
+        }
+        if(len != 12){
+            return -1;
+        }
+        int hlen = 12 + (h[10] | (h[11] << 8));
+        if(hlen + 8 > 65536 || std::fread(h + 12, 1, hlen - 12, mFile) != (size_t)(hlen - 12)){
+            return -1;
+        }
+        int bsize = getBgzfBlockSize(h, hlen);
+        if(bsize < hlen + 8){
+            return -1;
+        }
+        if(std::fread(h + hlen, 1, bsize - hlen, mFile) != (size_t)(bsize - hlen)){
+            return -1;
+        }
+        return bsize;
+    }
+
+    /** inflate a BGZF block in slot.raw into slot.out and check its crc32
+     * @param zs z_stream initialized for raw deflate
+     * @param slot BgzfSlot storing the compressed block
+     * @param bsize compressed block size
+     * @return inflated length, -1 if error occurs
+     */
+    inline static int inflateBgzfBlock(z_stream* zs, BgzfSlot& slot, int bsize){
+        const unsigned char* b = (const unsigned char*)slot.raw.data();
+        uint32_t crc = b[bsize - 8] | (b[bsize - 7] << 8) | (b[bsize - 6] << 16) | ((uint32_t)b[bsize - 5] << 24);
+        uint32_t isize = b[bsize - 4] | (b[bsize - 3] << 8) | (b[bsize - 2] << 16) | ((uint32_t)b[bsize - 1] << 24);
+        if(isize > 65536){
+            return -1;
+        }
+        slot.out.resize(65536);
+        if(inflateReset(zs) != Z_OK){
+            return -1;
+        }
+        int hlen = 12 + (b[10] | (b[11] << 8));
+        zs->next_in = (Bytef*)b + hlen;
+        zs->avail_in = bsize - hlen - 8;
+        zs->next_out = (Bytef*)slot.out.data();
+        zs->avail_out = slot.out.size();
+        if(inflate(zs, Z_FINISH) != Z_STREAM_END || zs->total_out != isize){
+            return -1;
+        }
+        if(crc32(crc32(0L, Z_NULL, 0), (const Bytef*)slot.out.data(), isize) != crc){
+            return -1;
+        }
+        return isize;
+    }
+
+    /** BGZF inflating thread routine, claim next block in order, read it under lock and inflate it without lock\n
+     * at most mBgzfSlots.size() blocks are inflated ahead of the consumer
+     */
+    inline void bgzfInflateLoop(){
+        z_stream zs;
+        std::memset(&zs, 0, sizeof(zs));
+        bool zok = inflateInit2(&zs, -15) == Z_OK;
+        std::unique_lock<std::mutex> l(mBgzfMtx);
+        while(true){
+            mBgzfCond.wait(l, [this]{return mBgzfStop || mBgzfReadEnd || mBgzfNextRead < mBgzfNextUse + mBgzfSlots.size();});
+            if(mBgzfStop || mBgzfReadEnd){
+                break;
+            }
+            BgzfSlot& slot = mBgzfSlots[mBgzfNextRead % mBgzfSlots.size()];
+            ++mBgzfNextRead;
+            int bsize = zok ? readBgzfBlock(slot) : -1;
+            if(bsize > 0){
+                mBgzfBytesRead += bsize;
+                mBytesRead.store(mBgzfBytesRead, std::memory_order_relaxed);
+            }
+            if(bsize <= 0){
+                slot.outLen = bsize;
+                slot.last = true;
+                slot.ready = true;
+                mBgzfReadEnd = true;
+                mBgzfCond.notify_all();
+                break;
+            }
+            l.unlock();
+            int outLen = inflateBgzfBlock(&zs, slot, bsize);
+            l.lock();
+            slot.outLen = outLen;
+            slot.last = outLen < 0;
+            slot.ready = true;
+            if(slot.last){
+                mBgzfReadEnd = true;
+            }
+            mBgzfCond.notify_all();
+        }
+        inflateEnd(&zs);
+    }
 };
 
 #endif
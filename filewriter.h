@@ -7,7 +7,31 @@
 #include <cstring>
 #include <iostream>
 #include <fstream>
+#include <map>
+#include <atomic>
+#include <vector>
+#include <charconv>
+#include <algorithm>
+#include <string_view>
+#include <unordered_map>
 #include <zlib.h>
+#include "util.h"
+#include "orderedpool.h"
+
+/** Structure to hold tabix index configuration, same as tbx_conf_t of htslib */
+struct TabixConf{
+    int32_t preset;   ///< file format, 0 for generic 1-based, 0x10000 for 0-based half-open(like bed)
+    int32_t sc;       ///< column of sequence name, 1-based
+    int32_t bc;       ///< column of region begin, 1-based
+    int32_t ec;       ///< column of region end, 1-based, 0 if region is one base at begin
+    int32_t metaChar; ///< lines started with this char are skipped
+    int32_t lineSkip; ///< number of lines to skip at the beginning
+};
+
+/** tabix configuration of bed file */
+static const TabixConf TBX_BED = {0x10000, 1, 2, 3, '#', 0};
+/** tabix configuration of gff/gtf file */
+static const TabixConf TBX_GFF = {0, 1, 4, 5, '#', 0};
 
 /** Class to write to gz file or ofstream */
 class FileWriter{
@@ -17,18 +41,57 @@ class FileWriter{
     bool mZipped;           ///< output file is mZipped or not
     int mCompressLevel;     ///< compression level for gz file
     bool mNeedClose;        ///< needed to be closed or not
+
+    int mThreads;                         ///< number of threads to compress BGZF blocks
+    bool mBgzf;                           ///< compress output into BGZF blocks in worker threads if true
+    bool mAsync;                          ///< data is buffered and written in background threads if true
+    FILE* mFile;                          ///< FILE pointer to write BGZF blocks to
+    std::string mBuf;                     ///< data appended but not submitted to worker threads or written yet
+    size_t mJobSize;                      ///< submit mBuf to worker threads once it reaches this size
+    size_t mMaxJobs;                      ///< maximum jobs submitted but not written yet
+    std::atomic<bool> mError;             ///< error occurs while compressing or writing if true
+    OrderedPool<std::string, std::string> mJobs; ///< threads to compress jobs(data of mBuf) into BGZF blocks and write them in order
+
+    /** Structure to hold tabix index of one sequence, offsets are uncompressed until written */
+    struct TabixRef{
+        std::map<uint32_t, std::vector<std::pair<uint64_t, uint64_t>>> bins; ///< chunks of each bin
+        std::vector<uint64_t> linear;                                        ///< minimum offset of records overlapping each 16kb window
+    };
+
+    bool mGzi;                                        ///< write .gzi index on close if true
+    bool mTabix;                                      ///< write .tbi index on close if true
+    TabixConf mTbxConf;                               ///< tabix index configuration
+    std::vector<std::pair<uint64_t, uint64_t>> mBlocks; ///< compressed and uncompressed offset of each BGZF block written
+    uint64_t mCOffset;                                ///< compressed Bytes written
+    uint64_t mUOffset;                                ///< uncompressed Bytes written
+    std::vector<std::string> mTbxNames;               ///< sequence names in tabix index
+    std::unordered_map<std::string, int32_t> mTbxTids; ///< sequence name to index in mTbxNames
+    std::vector<TabixRef> mTbxRefs;                   ///< tabix index of each sequence
+    std::string mTbxLine;                             ///< partial line left at the end of last job
+    uint64_t mTbxLineOff;                             ///< uncompressed offset of current line
+    uint64_t mTbxLineNo;                              ///< number of lines indexed
+    int32_t mTbxLastTid;                              ///< sequence index of last record
+    int64_t mTbxLastBeg;                              ///< begin of last record
+    bool mTbxError;                                   ///< input is not indexable if true
     
     public:
     /** FileWriter constructor
      * @param filename output filename
      * @param compression compression level for gzFile
+     * @param threads number of threads to compress gz output, if threads > 1 output is written as BGZF blocks compressed in parallel
+     * @param bgzf write gz output as BGZF blocks even if threads <= 1
+     * @param async buffer data in large blocks and compress/write them in a background thread
      */
-    FileWriter(const std::string& filename, const int& compression = 3){
+    FileWriter(const std::string& filename, const int& compression = 3, int threads = 1, bool bgzf = false, bool async = false){
         mCompressLevel = compression;
         mFilename = filename;
         mGzFile = NULL;
         mZipped = false;
         mNeedClose = true;
+        mThreads = threads;
+        initJobs();
+        mBgzf = bgzf;
+        mAsync = async;
         init();
     }
         
@@ -40,6 +103,8 @@ class FileWriter{
         mZipped = false;
         mStream = stream;
         mNeedClose = false; 
+        mThreads = 1;
+        initJobs();
     }
     
     /** FileWriter constructor
@@ -50,12 +115,16 @@ class FileWriter{
         mGzFile = gzfile;
         mZipped = true;
         mNeedClose = false;
+        mThreads = 1;
+        initJobs();
     }
     
     /** FileWriter destructor */
     ~FileWriter(){
         if(mNeedClose){
             close();
+        }else if(!mAsync && !mBuf.empty()){
+            writeBuf();
         }
     }
 
@@ -75,7 +144,9 @@ class FileWriter{
         size_t size = str.length();
         size_t written = 0;
         bool status = true;
-        if(mZipped){
+        if(mAsync || !mBuf.empty()){
+            status = append(cstr, size);
+        }else if(mZipped){
             written = gzwrite(mGzFile, cstr, size);
             status = size == written;
         }else{
@@ -94,7 +165,9 @@ class FileWriter{
         size_t size = linestr.length();
         size_t written = 0;
         bool status = true;
-        if(mZipped){
+        if(mAsync || !mBuf.empty()){
+            status = append(line, size) && append("\n", 1);
+        }else if(mZipped){
             written = gzwrite(mGzFile, line, size);
             gzputc(mGzFile, '\n');
             status = size == written;
@@ -114,7 +187,9 @@ class FileWriter{
     inline bool write(char* cstr, size_t size){
         size_t written = 0;
         bool status = true;
-        if(mZipped){
+        if(mAsync || !mBuf.empty()){
+            status = append(cstr, size);
+        }else if(mZipped){
             written = gzwrite(mGzFile, cstr, size);
             status = size == written;
         }else{
@@ -124,6 +199,90 @@ class FileWriter{
         return status;
     }
     
+    /** append data to output buffer, the buffer is written once it is large enough\n
+     * appended data is written in order with data written by writeString/writeLine/write
+     * @param data pointer to data
+     * @param size length of data
+     * @return false if any error occurs in compressing or writing
+     */
+    inline bool append(const char* data, size_t size){
+        mBuf.append(data, size);
+        return mBuf.size() < mJobSize ? !mError : commitBuf();
+    }
+
+    /** append a string to output buffer
+     * @param str string to be appended
+     * @return false if any error occurs in compressing or writing
+     */
+    inline bool append(std::string_view str){
+        return append(str.data(), str.size());
+    }
+
+    /** append a char to output buffer, appendChar('\t') and appendChar('\n') for separators
+     * @param c char to be appended
+     * @return false if any error occurs in compressing or writing
+     */
+    inline bool appendChar(char c){
+        mBuf.push_back(c);
+        return mBuf.size() < mJobSize ? !mError : commitBuf();
+    }
+
+    /** append an integer in decimal to output buffer
+     * @param val integer to be appended
+     * @return false if any error occurs in compressing or writing
+     */
+    template<typename T>
+    inline bool appendInt(T val){
+        size_t off = mBuf.size();
+        mBuf.resize(off + 24);
+        char* end = std::to_chars(&mBuf[off], &mBuf[off] + 24, val).ptr;
+        mBuf.resize(end - mBuf.data());
+        return mBuf.size() < mJobSize ? !mError : commitBuf();
+    }
+
+    /** append a floating point number in fixed notation to output buffer
+     * @param val number to be appended
+     * @param precision number of digits after decimal point
+     * @return false if any error occurs in compressing or writing
+     */
+    inline bool appendFloat(double val, int precision = 6){
+        char buf[64];
+        std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), val, std::chars_format::fixed, precision);
+        if(r.ec != std::errc()){
+            r = std::to_chars(buf, buf + sizeof(buf), val);
+        }
+        return append(buf, r.ptr - buf);
+    }
+
+    /** write all data buffered to file and flush file handler, wait until all background writes done in async mode
+     * @return true if all data written successfully
+     */
+    inline bool flush(){
+        if(mAsync){
+            if(!mBuf.empty()){
+                submitBuf();
+            }
+            mJobs.wait();
+        }else if(!mBuf.empty()){
+            writeBuf();
+        }
+        if(mBgzf){
+            if(mFile && std::fflush(mFile) != 0){
+                mError = true;
+            }
+        }else if(mZipped){
+            if(mGzFile && gzflush(mGzFile, Z_SYNC_FLUSH) != Z_OK){
+                mError = true;
+            }
+        }else if(mStream){
+            mStream->flush();
+            if(mStream->fail()){
+                mError = true;
+            }
+        }
+        return !mError;
+    }
+
     /** get filename of output file
      * @return output filename
      */
@@ -131,25 +290,93 @@ class FileWriter{
         return mFilename;
     }
 
+    /** Whether the output file is written as BGZF blocks or not
+     * @return true if output is BGZF
+     */
+    inline bool isBgzf(){
+        return mBgzf;
+    }
+
+    /** write .gzi index(filename + ".gzi") of BGZF output on close, must be called before anything written
+     * @return false if output is not BGZF or something has been written
+     */
+    inline bool buildGzi(){
+        if(!mBgzf || mJobs.submitted() || !mBuf.empty()){
+            return false;
+        }
+        mGzi = true;
+        return true;
+    }
+
+    /** write tabix index(filename + ".tbi") of BGZF output on close, must be called before anything written\n
+     * records must be sorted by sequence and begin, or else no index is written
+     * @param conf tabix index configuration, TBX_BED or TBX_GFF for example
+     * @return false if output is not BGZF or something has been written
+     */
+    inline bool buildTabix(const TabixConf& conf){
+        if(!mBgzf || mJobs.submitted() || !mBuf.empty()){
+            return false;
+        }
+        mTabix = true;
+        mTbxConf = conf;
+        return true;
+    }
+
     /** initialize FileWriter, detect file format and open file handler
      */
     inline void init(){
-        if(mFilename.length() >= 4 && mFilename.substr(mFilename.length() - 3) == ".gz"){
+        if(mFilename.length() >= 4 && mFilename.substr(mFilename.length() - 3) == ".gz" && (mThreads > 1 || mBgzf)){
+            mFile = std::fopen(mFilename.c_str(), "wb");
+            if(mFile == NULL){
+                std::cerr << "Failed to open file: " << mFilename << std::endl;
+                std::exit(1);
+            }
+            mZipped = true;
+            mBgzf = true;
+            mAsync = true;
+            mStream = NULL;
+        }else if(mFilename.length() >= 4 && mFilename.substr(mFilename.length() - 3) == ".gz"){
+            mBgzf = false;
             mGzFile = gzopen(mFilename.c_str(), "w");
             gzsetparams(mGzFile, mCompressLevel, Z_DEFAULT_STRATEGY);
             gzbuffer(mGzFile, 1024 * 1024);
             mZipped = true;
         }else{
+            mBgzf = false;
             mStream = new std::ofstream();
             mStream->open(mFilename.c_str(), std::ios::out);
             mZipped = false;
         }
+        if(mAsync){
+            mJobs.start(mBgzf ? std::max(1, mThreads) : 1, mMaxJobs, BgzfDeflater(this), [this](std::string& data, std::string& out){
+                if(!mError && !sinkJob(data, out)){
+                    mError = true;
+                }
+                data.clear();
+            });
+        }
     }
     
     /** flush buffer and close file handler
      */
     inline void close(){
-        if(mZipped){
+        if(mAsync){
+            stopJobs();
+        }else if(!mAsync && !mBuf.empty()){
+            writeBuf();
+        }
+        if(mBgzf){
+            if(mFile){
+                if(!mError && std::fwrite(BGZF_EOF, 1, sizeof(BGZF_EOF), mFile) != sizeof(BGZF_EOF)){
+                    mError = true;
+                }
+                std::fclose(mFile);
+                mFile = NULL;
+                if(!mError){
+                    writeIndex();
+                }
+            }
+        }else if(mZipped){
             if(mGzFile){
                 gzflush(mGzFile, Z_FINISH);
                 gzclose(mGzFile);
@@ -162,6 +389,445 @@ class FileWriter{
             }
         }
     }
+
+    private:
+    /** empty BGZF block marking the end of a BGZF file */
+    static constexpr unsigned char BGZF_EOF[28] = {
+        31, 139, 8, 4, 0, 0, 0, 0, 0, 255, 6, 0, 66, 67, 2, 0, 27, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0
+    };
+
+    /** maximum uncompressed Bytes in a BGZF block */
+    static constexpr size_t BGZF_BLOCK_DATA = 0xff00;
+
+    /** initialize job queue status */
+    inline void initJobs(){
+        mBgzf = false;
+        mAsync = false;
+        mFile = NULL;
+        mJobSize = BGZF_BLOCK_DATA * 16;
+        mMaxJobs = std::max(1, mThreads) * 4;
+        mError = false;
+        mGzi = false;
+        mTabix = false;
+        mCOffset = 0;
+        mUOffset = 0;
+        mTbxLineOff = 0;
+        mTbxLineNo = 0;
+        mTbxLastTid = -1;
+        mTbxLastBeg = -1;
+        mTbxError = false;
+    }
+
+    /** submit mBuf to worker threads in async mode, or else write it to file directly
+     * @return false if any error occurs in compressing or writing
+     */
+    inline bool commitBuf(){
+        if(mAsync){
+            submitBuf();
+        }else{
+            writeBuf();
+        }
+        return !mError;
+    }
+
+    /** write mBuf to file in calling thread and clear it */
+    inline void writeBuf(){
+        if(mZipped){
+            if(gzwrite(mGzFile, mBuf.data(), mBuf.size()) != (int)mBuf.size()){
+                mError = true;
+            }
+        }else{
+            mStream->write(mBuf.data(), mBuf.size());
+            if(mStream->fail()){
+                mError = true;
+            }
+        }
+        mBuf.clear();
+    }
+
+    /** submit mBuf as a job to worker threads, wait if too many jobs not written yet */
+    inline void submitBuf(){
+        mJobs.submit(std::move(mBuf));
+        mBuf.clear();
+        mJobs.acquire(mBuf);
+    }
+
+    /** submit data left in mBuf, wait until all jobs written and stop worker threads */
+    inline void stopJobs(){
+        if(!mBuf.empty()){
+            submitBuf();
+        }
+        mJobs.finish();
+    }
+
+    /** compress data into one BGZF block appended to out
+     * @param zs z_stream initialized for raw deflate
+     * @param data pointer to data
+     * @param size length of data, at most BGZF_BLOCK_DATA
+     * @param out string to append BGZF block to
+     * @return true if compressed successfully
+     */
+    inline static bool compressBgzfBlock(z_stream* zs, const char* data, size_t size, std::string& out){
+        size_t off = out.size();
+        out.resize(off + 65536);
+        unsigned char* b = (unsigned char*)&out[off];
+        std::memcpy(b, BGZF_EOF, 18);
+        if(deflateReset(zs) != Z_OK){
+            return false;
+        }
+        zs->next_in = (Bytef*)data;
+        zs->avail_in = size;
+        zs->next_out = b + 18;
+        zs->avail_out = 65536 - 26;
+        if(deflate(zs, Z_FINISH) != Z_STREAM_END){
+            return false;
+        }
+        size_t bsize = zs->total_out + 26;
+        uint32_t crc = crc32(crc32(0L, Z_NULL, 0), (const Bytef*)data, size);
+        b[16] = (bsize - 1) & 0xff;
+        b[17] = (bsize - 1) >> 8;
+        for(int i = 0; i < 4; ++i){
+            b[bsize - 8 + i] = (crc >> (8 * i)) & 0xff;
+            b[bsize - 4 + i] = (size >> (8 * i)) & 0xff;
+        }
+        out.resize(off + bsize);
+        return true;
+    }
+
+    /** write a processed job to output file
+     * @param data uncompressed data of job
+     * @param out compressed BGZF blocks of data, empty if output is not BGZF
+     * @return true if written successfully
+     */
+    inline bool sinkJob(const std::string& data, const std::string& out){
+        if(!mBgzf){
+            if(mZipped){
+                return gzwrite(mGzFile, data.data(), data.size()) == (int)data.size();
+            }
+            mStream->write(data.data(), data.size());
+            return !mStream->fail();
+        }
+        if(mGzi || mTabix){
+            const unsigned char* b = (const unsigned char*)out.data();
+            size_t usize = data.size();
+            for(size_t off = 0; off < out.size(); usize -= std::min(usize, BGZF_BLOCK_DATA)){
+                size_t bsize = (b[off + 16] | (b[off + 17] << 8)) + 1;
+                mBlocks.emplace_back(mCOffset, mUOffset);
+                mCOffset += bsize;
+                mUOffset += std::min(usize, BGZF_BLOCK_DATA);
+                off += bsize;
+            }
+            if(mTabix && !mTbxError){
+                indexLines(data, mUOffset - data.size());
+            }
+        }
+        return std::fwrite(out.data(), 1, out.size(), mFile) == out.size();
+    }
+
+    /** compute tabix bin of a region, same as reg2bin of htslib
+     * @param beg 0-based region begin
+     * @param end 0-based region end, exclusive
+     * @return bin of region
+     */
+    inline static uint32_t reg2bin(int64_t beg, int64_t end){
+        --end;
+        if(beg >> 14 == end >> 14) return ((1 << 15) - 1) / 7 + (beg >> 14);
+        if(beg >> 17 == end >> 17) return ((1 << 12) - 1) / 7 + (beg >> 17);
+        if(beg >> 20 == end >> 20) return ((1 << 9) - 1) / 7 + (beg >> 20);
+        if(beg >> 23 == end >> 23) return ((1 << 6) - 1) / 7 + (beg >> 23);
+        if(beg >> 26 == end >> 26) return ((1 << 3) - 1) / 7 + (beg >> 26);
+        return 0;
+    }
+
+    /** add complete lines in data to tabix index, partial line at the end is kept in mTbxLine
+     * @param data uncompressed data of a job
+     * @param uoff uncompressed offset of data
+     */
+    inline void indexLines(const std::string& data, uint64_t uoff){
+        const char* beg = data.data();
+        const char* end = beg + data.size();
+        while(beg < end && !mTbxError){
+            if(mTbxLine.empty()){
+                mTbxLineOff = uoff + (beg - data.data());
+            }
+            const char* pos = (const char*)std::memchr(beg, '\n', end - beg);
+            if(pos == NULL){
+                mTbxLine.append(beg, end - beg);
+                break;
+            }
+            uint64_t lend = uoff + (pos - data.data()) + 1;
+            if(mTbxLine.empty()){
+                indexLine(beg, pos - beg, lend);
+            }else{
+                mTbxLine.append(beg, pos - beg);
+                indexLine(mTbxLine.data(), mTbxLine.size(), lend);
+                mTbxLine.clear();
+            }
+            beg = pos + 1;
+        }
+    }
+
+    /** add a line to tabix index
+     * @param line pointer to line without trailing \n
+     * @param len length of line
+     * @param lend uncompressed offset of the end of line
+     */
+    inline void indexLine(const char* line, size_t len, uint64_t lend){
+        ++mTbxLineNo;
+        if(mTbxLineNo <= (uint64_t)mTbxConf.lineSkip || len == 0 || line[0] == mTbxConf.metaChar){
+            return;
+        }
+        int32_t ncol = std::max(mTbxConf.sc, std::max(mTbxConf.bc, mTbxConf.ec));
+        const char* cols[3] = {NULL, NULL, NULL};
+        size_t lens[3] = {0, 0, 0};
+        const char* beg = line;
+        const char* end = line + len;
+        for(int32_t c = 1; c <= ncol && beg <= end; ++c){
+            const char* pos = (const char*)std::memchr(beg, '\t', end - beg);
+            if(pos == NULL){
+                pos = end;
+            }
+            int32_t k = c == mTbxConf.sc ? 0 : (c == mTbxConf.bc ? 1 : (c == mTbxConf.ec ? 2 : -1));
+            if(k >= 0){
+                cols[k] = beg;
+                lens[k] = pos - beg;
+            }
+            beg = pos + 1;
+        }
+        if(!cols[0] || !cols[1] || (mTbxConf.ec && !cols[2])){
+            std::cerr << "Failed to build tabix index for " << mFilename << ", line " << mTbxLineNo << " has too few columns" << std::endl;
+            mTbxError = true;
+            return;
+        }
+        int64_t rbeg = 0, rend = 0;
+        if(!util::str2num(std::string_view(cols[1], lens[1]), rbeg) || (mTbxConf.ec && !util::str2num(std::string_view(cols[2], lens[2]), rend))){
+            std::cerr << "Failed to build tabix index for " << mFilename << ", line " << mTbxLineNo << " has invalid positions" << std::endl;
+            mTbxError = true;
+            return;
+        }
+        if(!mTbxConf.ec){
+            rend = rbeg;
+        }
+        if(!(mTbxConf.preset & 0x10000)){
+            --rbeg;
+        }else if(!mTbxConf.ec){
+            ++rend;
+        }
+        rbeg = std::max((int64_t)0, rbeg);
+        if(rend <= rbeg){
+            rend = rbeg + 1;
+        }
+        std::string_view name(cols[0], lens[0]);
+        int32_t tid = mTbxLastTid;
+        if(tid < 0 || mTbxNames[tid] != name){
+            std::string sname(name);
+            if(mTbxTids.count(sname)){
+                std::cerr << "Failed to build tabix index for " << mFilename << ", " << sname << " is not contiguous at line " << mTbxLineNo << std::endl;
+                mTbxError = true;
+                return;
+            }
+            tid = mTbxNames.size();
+            mTbxTids[sname] = tid;
+            mTbxNames.push_back(sname);
+            mTbxRefs.push_back(TabixRef());
+            mTbxLastBeg = -1;
+        }
+        if(rbeg < mTbxLastBeg){
+            std::cerr << "Failed to build tabix index for " << mFilename << ", records are not sorted at line " << mTbxLineNo << std::endl;
+            mTbxError = true;
+            return;
+        }
+        mTbxLastTid = tid;
+        mTbxLastBeg = rbeg;
+        TabixRef& ref = mTbxRefs[tid];
+        auto& chunks = ref.bins[reg2bin(rbeg, rend)];
+        if(!chunks.empty() && chunks.back().second == mTbxLineOff){
+            chunks.back().second = lend;
+        }else{
+            chunks.emplace_back(mTbxLineOff, lend);
+        }
+        size_t wend = (rend - 1) >> 14;
+        if(ref.linear.size() <= wend){
+            ref.linear.resize(wend + 1, UINT64_MAX);
+        }
+        for(size_t w = rbeg >> 14; w <= wend; ++w){
+            if(ref.linear[w] == UINT64_MAX){
+                ref.linear[w] = mTbxLineOff;
+            }
+        }
+    }
+
+    /** convert uncompressed offset to BGZF virtual offset
+     * @param uoff uncompressed offset
+     * @return virtual offset
+     */
+    inline uint64_t virtualOffset(uint64_t uoff){
+        auto iter = std::upper_bound(mBlocks.begin(), mBlocks.end(), uoff, [](uint64_t u, const std::pair<uint64_t, uint64_t>& b){return u < b.second;});
+        --iter;
+        return (iter->first << 16) | (uoff - iter->second);
+    }
+
+    /** write .gzi and .tbi index on close */
+    inline void writeIndex(){
+        if(!mGzi && !mTabix){
+            return;
+        }
+        if(mBlocks.empty()){
+            mBlocks.emplace_back(0, 0);
+        }
+        mBlocks.emplace_back(mCOffset, mUOffset);
+        if(mGzi){
+            std::string gzi;
+            putInt<uint64_t>(gzi, mBlocks.size() - 1);
+            for(size_t i = 1; i < mBlocks.size(); ++i){
+                putInt<uint64_t>(gzi, mBlocks[i].first);
+                putInt<uint64_t>(gzi, mBlocks[i].second);
+            }
+            writeIndexFile(mFilename + ".gzi", gzi, false);
+        }
+        if(mTabix){
+            if(!mTbxLine.empty() && !mTbxError){
+                indexLine(mTbxLine.data(), mTbxLine.size(), mUOffset);
+            }
+            if(mTbxError){
+                return;
+            }
+            std::string tbi("TBI\1", 4);
+            putInt<int32_t>(tbi, mTbxNames.size());
+            putInt<int32_t>(tbi, mTbxConf.preset);
+            putInt<int32_t>(tbi, mTbxConf.sc);
+            putInt<int32_t>(tbi, mTbxConf.bc);
+            putInt<int32_t>(tbi, mTbxConf.ec);
+            putInt<int32_t>(tbi, mTbxConf.metaChar);
+            putInt<int32_t>(tbi, mTbxConf.lineSkip);
+            int32_t lnm = 0;
+            for(auto& n: mTbxNames){
+                lnm += n.size() + 1;
+            }
+            putInt<int32_t>(tbi, lnm);
+            for(auto& n: mTbxNames){
+                tbi.append(n.c_str(), n.size() + 1);
+            }
+            for(auto& ref: mTbxRefs){
+                putInt<int32_t>(tbi, ref.bins.size());
+                for(auto& bin: ref.bins){
+                    putInt<uint32_t>(tbi, bin.first);
+                    putInt<int32_t>(tbi, bin.second.size());
+                    for(auto& c: bin.second){
+                        putInt<uint64_t>(tbi, virtualOffset(c.first));
+                        putInt<uint64_t>(tbi, virtualOffset(c.second));
+                    }
+                }
+                putInt<int32_t>(tbi, ref.linear.size());
+                uint64_t last = ref.bins.empty() ? 0 : UINT64_MAX;
+                for(auto& bin: ref.bins){
+                    last = std::min(last, bin.second.front().first);
+                }
+                for(auto& l: ref.linear){
+                    if(l != UINT64_MAX){
+                        last = l;
+                    }
+                    putInt<uint64_t>(tbi, virtualOffset(last));
+                }
+            }
+            writeIndexFile(mFilename + ".tbi", tbi, true);
+        }
+    }
+
+    /** append an integer to string in little endian
+     * @param out string to append to
+     * @param val integer to be appended
+     */
+    template<typename T>
+    inline static void putInt(std::string& out, T val){
+        for(size_t i = 0; i < sizeof(T); ++i){
+            out.push_back((char)(((uint64_t)val >> (8 * i)) & 0xff));
+        }
+    }
+
+    /** write an index file
+     * @param filename index filename
+     * @param data index content
+     * @param bgzf compress index content as BGZF if true
+     */
+    inline void writeIndexFile(const std::string& filename, const std::string& data, bool bgzf){
+        std::string out;
+        if(bgzf){
+            z_stream zs;
+            std::memset(&zs, 0, sizeof(zs));
+            bool ok = deflateInit2(&zs, mCompressLevel, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+            for(size_t i = 0; ok && i < data.size(); i += BGZF_BLOCK_DATA){
+                ok = compressBgzfBlock(&zs, data.data() + i, std::min(BGZF_BLOCK_DATA, data.size() - i), out);
+            }
+            deflateEnd(&zs);
+            if(!ok){
+                std::cerr << "Failed to compress index file: " << filename << std::endl;
+                return;
+            }
+            out.append((const char*)BGZF_EOF, sizeof(BGZF_EOF));
+        }
+        FILE* fp = std::fopen(filename.c_str(), "wb");
+        if(fp == NULL){
+            std::cerr << "Failed to open file: " << filename << std::endl;
+            return;
+        }
+        const std::string& buf = bgzf ? out : data;
+        if(std::fwrite(buf.data(), 1, buf.size(), fp) != buf.size()){
+            std::cerr << "Failed to write file: " << filename << std::endl;
+        }
+        std::fclose(fp);
+    }
+
+    /** Functor to compress data of a job into BGZF blocks in worker threads, each worker owns a copy with its own z_stream */
+    struct BgzfDeflater{
+        FileWriter* writer; ///< FileWriter whose jobs are compressed
+        z_stream zs;        ///< raw deflate stream, initialized at first use
+        bool inited;        ///< zs has been initialized if true
+        bool zok;           ///< zs initialized successfully if true
+
+        /** Construct a BgzfDeflater
+         * @param fw FileWriter whose jobs are compressed
+         */
+        BgzfDeflater(FileWriter* fw){
+            writer = fw;
+            inited = false;
+            zok = false;
+        }
+
+        /** copy constructor, the z_stream is not shared but initialized by the copy at first use
+         * @param other BgzfDeflater to copy from
+         */
+        BgzfDeflater(const BgzfDeflater& other): BgzfDeflater(other.writer){}
+
+        /** BgzfDeflater destructor */
+        ~BgzfDeflater(){
+            if(inited && zok){
+                deflateEnd(&zs);
+            }
+        }
+
+        /** compress data into BGZF blocks appended to out, nothing done if output is not BGZF
+         * @param data uncompressed data of job
+         * @param out string to append BGZF blocks to
+         */
+        inline void operator()(std::string& data, std::string& out){
+            if(!writer->mBgzf){
+                return;
+            }
+            if(!inited){
+                std::memset(&zs, 0, sizeof(zs));
+                zok = deflateInit2(&zs, writer->mCompressLevel, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) == Z_OK;
+                inited = true;
+            }
+            bool ok = zok;
+            for(size_t i = 0; ok && i < data.size(); i += BGZF_BLOCK_DATA){
+                ok = compressBgzfBlock(&zs, data.data() + i, std::min(BGZF_BLOCK_DATA, data.size() - i), out);
+            }
+            if(!ok){
+                writer->mError = true;
+            }
+        }
+    };
 };
 
 #endif
@@ -0,0 +1,24 @@
+#include <zlib.h>
+#include <string>
+#include <cstdlib>
+#include <iostream>
+#include "seqwriter.h"
+#include "seqpipeline.h"
+
+int main(int argc, char** argv){
+    if(argc < 3){
+        std::cout << argv[0] << " <in.fq> <out.fa> [threads]" << std::endl;
+        return 0;
+    }
+    int threads = argc > 3 ? std::atoi(argv[3]) : 1;
+    SeqPipeline sp(argv[1], threads);
+    FileWriter ofp(argv[2], Z_DEFAULT_COMPRESSION, threads, false, true);
+    bool ok = sp.run<std::string>([](const krec_t* recs, int n, std::string& out){
+        for(int i = 0; i < n; ++i){
+            SeqWriter::formatFasta(out, std::string_view(recs[i].name.s, recs[i].name.l), std::string_view(recs[i].seq.s, recs[i].seq.l));
+        }
+    }, [&](std::string& out){
+        ofp.append(out);
+    });
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,30 @@
+#include <zlib.h>
+#include <string>
+#include <cstdlib>
+#include <iostream>
+#include "seqwriter.h"
+#include "seqpipeline.h"
+
+int main(int argc, char** argv){
+    if(argc < 5){
+        std::cout << argv[0] << " <in.fq> <out.fq> <barcode> <quality> [threads]" << std::endl;
+        return 0;
+    }
+    std::string bcseq = argv[3];
+    std::string quaseq = argv[4];
+    int threads = argc > 5 ? std::atoi(argv[5]) : 1;
+    SeqPipeline sp(argv[1], threads);
+    FileWriter ofp(argv[2], 1, threads, false, true);
+    bool ok = sp.run<std::string>([&](const krec_t* recs, int n, std::string& out){
+        std::string seq;
+        std::string qual;
+        for(int i = 0; i < n; ++i){
+            seq.assign(bcseq).append(recs[i].seq.s, recs[i].seq.l);
+            qual.assign(quaseq).append(recs[i].qual.s, recs[i].qual.l);
+            SeqWriter::formatFastq(out, std::string_view(recs[i].name.s, recs[i].name.l), seq, qual, std::string_view(recs[i].comment.s, recs[i].comment.l));
+        }
+    }, [&](std::string& out){
+        ofp.append(out);
+    });
+    return ok ? 0 : 1;
+}
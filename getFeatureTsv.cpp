@@ -1,85 +1,135 @@
 #include <map>
 #include <util.h>
 #include <stdio.h>
-#include <fstream>
-#include <sstream>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <string_view>
 #include <htslib/bgzf.h>
-#include <htslib/kstring.h>
+#include "filereader.h"
+#include "lineprocessor.h"
+
+/** append one feature record to out
+ * @param out string to append the record to
+ * @param chr chromosome name
+ * @param beg feature start position
+ * @param end feature end position
+ * @param strand transcript strand
+ * @param feature feature type(utr5, utr3, exon, intron)
+ * @param count feature count in transcript direction
+ * @param trs transcript name
+ * @param gene gene name
+ * @param version transcript version
+ */
+void appendFeature(std::string& out, std::string_view chr, int32_t beg, int32_t end, std::string_view strand, const char* feature,
+                   size_t count, std::string_view trs, std::string_view gene, std::string_view version){
+    out.append(chr);
+    out.append("\t").append(std::to_string(beg));
+    out.append("\t").append(std::to_string(end));
+    out.append("\t").append(strand);
+    out.append("\t").append(feature);
+    out.append("\t").append(std::to_string(count));
+    out.append("\t").append(trs);
+    out.append("\t").append(gene);
+    out.append("\t").append(version);
+    out.append("\n");
+}
+
+/** convert one UCSC refGene line to feature records
+ * @param line refGene line with accession
+ * @param out string to append feature records to
+ */
+void appendFeatures(std::string_view line, std::string& out){
+    std::vector<std::string_view> vstr, istr, estr;
+    util::splitView(line, vstr, "\t");
+    if(vstr.size() < 17){
+        return;
+    }
+    std::string_view trs = vstr[1];
+    std::string_view chr = vstr[2];
+    std::string_view gene = vstr[12];
+    std::string_view version = vstr[16];
+    std::string_view strand = vstr[3];
+    int32_t trsStart = util::str2num<int32_t>(vstr[4]);
+    int32_t trsEnd = util::str2num<int32_t>(vstr[5]) - 1;
+    int32_t cdsStart = util::str2num<int32_t>(vstr[6]);
+    int32_t cdsEnd = util::str2num<int32_t>(vstr[7]) - 1;
+    // utr range
+    int32_t utr5start = trsStart;
+    int32_t utr5end = cdsStart - 1;
+    int32_t utr3start = cdsEnd + 1;
+    int32_t utr3end = trsEnd;
+    if(strand[0] == '-'){
+        utr5start = cdsEnd + 1;
+        utr5end = trsEnd;
+        utr3start = trsStart;
+        utr3end = cdsStart - 1;
+    }
+    if(utr5start < utr5end){
+        appendFeature(out, chr, utr5start, utr5end, strand, "utr5", 0, trs, gene, version);
+    }
+    if(utr3start < utr3end){
+        appendFeature(out, chr, utr3start, utr3end, strand, "utr3", 0, trs, gene, version);
+    }
+    // exon range
+    util::splitView(vstr[9], istr, ",");
+    util::splitView(vstr[10], estr, ",");
+    std::vector<int32_t> iint, eint;
+    for(auto& e: istr){
+        iint.push_back(util::str2num<int32_t>(e));
+    }
+    for(auto& e: estr){
+        eint.push_back(util::str2num<int32_t>(e));
+    }
+    size_t nexon = std::min(iint.size(), eint.size());
+    for(size_t i = 0; i < nexon; ++i){
+        appendFeature(out, chr, iint[i], eint[i] - 1, strand, "exon", strand[0] == '+' ? i + 1 : nexon - i, trs, gene, version);
+    }
+    // intron range
+    std::vector<int32_t> intronbeg;
+    std::vector<int32_t> intronend;
+    for(size_t i = 0; i + 1 < nexon; ++i){
+        if(eint[i] < iint[i + 1] - 1){
+            intronbeg.push_back(eint[i]);
+            intronend.push_back(iint[i + 1] - 1);
+        }
+    }
+    for(size_t i = 0; i < intronbeg.size(); ++i){
+        appendFeature(out, chr, intronbeg[i], intronend[i], strand, "intron", strand[0] == '+' ? i + 1 : intronbeg.size() - i, trs, gene, version);
+    }
+}
 
 int main(int argc, char** argv){
     if(argc < 3){
-        printf("%s <refGene.Acc.tsv.gz> <refGene.Anno.gz>\n", argv[0]);
+        printf("%s <refGene.Acc.tsv.gz> <refGene.Anno.gz> [threads]\n", argv[0]);
         return 0;
     }
-    BGZF* ifp = bgzf_open(argv[1], "rb");
+    int threads = argc > 3 ? std::max(1, std::atoi(argv[3])) : 1;
+    FileReader reader(argv[1], false, threads);
     BGZF* ofp = bgzf_open(argv[2], "wb");
-    kstring_t str = {0, 0, 0};
-    bgzf_getline(ifp, '\n', &str);
-    std::vector<std::string> vstr;
-    std::vector<std::string> istr, estr;
-    std::vector<int32_t> iint, eint;
-    std::stringstream oss;
+    if(ofp == NULL){
+        std::cerr << "Failed to open file: " << argv[2] << std::endl;
+        return 1;
+    }
+    std::string_view header;
+    reader.getline(header);
     // chr start end strand feature count trsname tgenename trsversion
-    while(bgzf_getline(ifp, '\n', &str) > 0){
-        oss.str(""); 
-        oss.clear();
-        util::split(str.s, vstr, "\t");
-        std::string trs = vstr[1];
-        std::string chr = vstr[2];
-        std::string gene = vstr[12];
-        std::string version = vstr[16];
-        std::string strand = vstr[3];
-        int32_t trsStart = std::atoi(vstr[4].c_str());
-        int32_t trsEnd = std::atoi(vstr[5].c_str()) - 1;
-        int32_t cdsStart = std::atoi(vstr[6].c_str());
-        int32_t cdsEnd = std::atoi(vstr[7].c_str()) - 1;
-        // utr range
-        int32_t utr5start = trsStart;
-        int32_t utr5end = cdsStart - 1;
-        int32_t utr3start = cdsEnd + 1;
-        int32_t utr3end = trsEnd;
-        if(strand[0] == '-'){
-            utr5start = cdsEnd + 1;
-            utr5end = trsEnd;
-            utr3start = trsStart;
-            utr3end = cdsStart - 1;
-        }
-        if(utr5start < utr5end){
-            oss << chr << "\t" << utr5start << "\t" << utr5end << "\t" << strand << "\tutr5\t0\t" << trs << "\t" << gene << "\t" << version << "\n";
+    // sink is called serially, a failed write stops later writes and is reported after all threads finished
+    bool failed = false;
+    LineProcessor processor(&reader, threads);
+    processor.run<std::string>([](std::string_view line, std::string& recs){
+        appendFeatures(line, recs);
+    }, [&](std::string& recs){
+        if(!failed && bgzf_write(ofp, recs.c_str(), recs.size()) < 0){
+            failed = true;
         }
-        if(utr3start < utr3end){
-            oss << chr << "\t" << utr3start << "\t" << utr3end << "\t" << strand << "\tutr3\t0\t" << trs << "\t" << gene << "\t" << version << "\n";
-        }
-        // exon range
-        util::split(vstr[9], istr, ",");
-        util::split(vstr[10], estr, ",");
-        util::strvec2intvec(istr, iint);
-        util::strvec2intvec(estr, eint);
-        for(uint32_t i = 0; i < iint.size(); ++i){
-            oss << chr << "\t" << iint[i] << "\t" << (eint[i] - 1) << "\t" << strand << "\texon\t";
-            if(strand[0] == '+') oss << i + 1;
-            else oss << (iint.size() - i);
-            oss << "\t" << trs << "\t" << gene << "\t" << version << "\n";
-        }
-        // intron range
-        std::vector<int32_t> intronbeg;
-        std::vector<int32_t> intronend;
-        for(uint32_t i = 0; i < iint.size() - 1; ++i){
-            if(eint[i] < iint[i + 1] - 1){
-                intronbeg.push_back(eint[i]);
-                intronend.push_back(iint[i + 1] - 1);
-            }
-        }
-        for(uint32_t i = 0; i < intronbeg.size(); ++i){
-            oss << chr << "\t" << intronbeg[i] << "\t" << intronend[i] << "\t" << strand << "\tintron\t";
-            if(strand[0] == '+') oss << i + 1;
-            else oss << (intronbeg.size() - i);
-            oss << "\t" << trs << "\t" << gene << "\t" << version << "\n";
-        }
-        // output str
-        std::string recs = oss.str();
-        assert(bgzf_write(ofp, recs.c_str(), recs.size()) >= 0);
+    });
+    if(bgzf_close(ofp) < 0){
+        failed = true;
+    }
+    if(failed){
+        std::cerr << "failed to write " << argv[2] << std::endl;
+        return 1;
     }
-    bgzf_close(ofp);
-    bgzf_close(ifp);
+    return 0;
 }
@@ -5,8 +5,8 @@
 #include <iostream>
 #include <unordered_set>
 #include <iomanip>
-
-KSEQ_INIT(gzFile, gzread)
+#include "seqwriter.h"
+#include "pairedreader.h"
 
 int main(int argc, char** argv){
     if(argc < 7){
@@ -46,46 +46,32 @@ int main(int argc, char** argv){
     bam_hdr_destroy(bh);
     sam_close(fp);
 
-    gzFile fqi1 = gzopen(infq1, "r");
-    gzFile fqi2 = gzopen(infq2, "r");
-    kseq_t* seq1 = kseq_init(fqi1);
-    kseq_t* seq2 = kseq_init(fqi2);
-    gzFile fqo1 = gzopen(outfq1, "w");
-    gzFile fqo2 = gzopen(outfq2, "w");
-    gzsetparams(fqo1, 4, Z_DEFAULT_STRATEGY);
-    gzsetparams(fqo2, 4, Z_DEFAULT_STRATEGY);
+    PairedReader reader(infq1, infq2, 4096, false);
+    SeqPairBatch batch;
+    SeqWriter fqo1(outfq1, 4);
+    SeqWriter fqo2(outfq2, 4);
     int32_t outcount = 0;
-    while(kseq_read(seq1) >= 0 && kseq_read(seq2) >= 0){
-        if(rname.count(seq1->name.s) > 0){
-            gzputc(fqo1, '@');
-            gzwrite(fqo1, seq1->name.s, seq1->name.l);
-            gzputc(fqo1, '\n');
-            gzwrite(fqo1, seq1->seq.s, seq1->seq.l);
-            gzwrite(fqo1, "\n+\n", 3);
-            gzwrite(fqo1, seq1->qual.s, seq1->qual.l);
-            gzputc(fqo1, '\n');
-
-            gzputc(fqo2, '@');
-            gzwrite(fqo2, seq2->name.s, seq2->name.l);
-            gzputc(fqo2, '\n');
-            gzwrite(fqo2, seq2->seq.s, seq2->seq.l);
-            gzwrite(fqo2, "\n+\n", 3);
-            gzwrite(fqo2, seq2->qual.s, seq2->qual.l);
-            gzputc(fqo2, '\n');
-            ++outcount;
+    bool written = true;
+    while(reader.read(batch)){
+        for(int i = 0; i < batch.n; ++i){
+            const krec_t* rec1 = &batch.r1[i];
+            const krec_t* rec2 = &batch.r2[i];
+            if(rname.count(rec1->name.s) > 0){
+                written &= fqo1.writeFastq(std::string_view(rec1->name.s, rec1->name.l), std::string_view(rec1->seq.s, rec1->seq.l), std::string_view(rec1->qual.s, rec1->qual.l));
+                written &= fqo2.writeFastq(std::string_view(rec2->name.s, rec2->name.l), std::string_view(rec2->seq.s, rec2->seq.l), std::string_view(rec2->qual.s, rec2->qual.l));
+                ++outcount;
+            }
         }
     }
-    gzflush(fqo1, Z_FINISH);
-    gzflush(fqo2, Z_FINISH);
-    gzclose(fqo1);
-    gzclose(fqo2);
-    kseq_destroy(seq1);
-    kseq_destroy(seq2);
-    gzclose(fqi1);
-    gzclose(fqi2);
-    fqo1 = NULL;
-    fqo2 = NULL;
-    fqi1 = NULL;
-    fqi2 = NULL;
+    written &= fqo1.flush();
+    written &= fqo2.flush();
+    if(!written){
+        std::cerr << "Failed to write " << outfq1 << " or " << outfq2 << std::endl;
+        return 1;
+    }
+    if(!reader.good()){
+        std::cerr << "Failed to read all pairs of " << infq1 << " and " << infq2 << ", output is incomplete" << std::endl;
+        return 1;
+    }
     std::cout << "total output read pairs: " << outcount << std::endl;
 }
@@ -1,6 +1,5 @@
 #include <set>
 #include <fstream>
-#include <sstream>
 #include <string>
 #include <algorithm>
 #include <utility>
@@ -55,25 +54,53 @@ struct ExonRecord{
             std::swap(utr3Len, utr5Len);
         }
     }
-    friend std::ostream& operator<<(std::ostream& os, const ExonRecord& rec){
-        if(rec.exoncoord.size() == 0){
-            return os;
+    void write(FileWriter& fw) const{
+        if(exoncoord.size() == 0){
+            return;
         }
-        os << "#" << rec.trsName << "\t" << rec.geneLen << "\t" << rec.cdsLen << "\t" << rec.utr5Len << "\t" << rec.utr3Len << "\n";
-        os << ">" << rec.geneName << "_" << rec.trsName << "." << rec.trsVer << ",";
-        os << rec.chromeName << ":" << rec.cdsStart << "-" << rec.cdsEnd << "\n";
+        fw.appendChar('#');
+        fw.append(trsName);
+        fw.appendChar('\t');
+        fw.appendInt(geneLen);
+        fw.appendChar('\t');
+        fw.appendInt(cdsLen);
+        fw.appendChar('\t');
+        fw.appendInt(utr5Len);
+        fw.appendChar('\t');
+        fw.appendInt(utr3Len);
+        fw.appendChar('\n');
+        fw.appendChar('>');
+        fw.append(geneName);
+        fw.appendChar('_');
+        fw.append(trsName);
+        fw.appendChar('.');
+        fw.append(trsVer);
+        fw.appendChar(',');
+        fw.append(chromeName);
+        fw.appendChar(':');
+        fw.appendInt(cdsStart);
+        fw.appendChar('-');
+        fw.appendInt(cdsEnd);
+        fw.appendChar('\n');
         int i = 0;
-        if(rec.strand == '+'){
-            for(int k = rec.firstCDSIndex; k <= rec.lastCDSIndex; ++k){
-                os << (++i) << "," << rec.exoncoord[k].first << "," << rec.exoncoord[k].second << "\n";
+        if(strand == '+'){
+            for(int k = firstCDSIndex; k <= lastCDSIndex; ++k){
+                writeExon(fw, ++i, exoncoord[k]);
             }
-            os << std::endl;
+            fw.appendChar('\n');
         }else{
-            for(int k = rec.lastCDSIndex; k >= rec.firstCDSIndex; --k){
-                os << (++i) << "," << rec.exoncoord[k].first << "," << rec.exoncoord[k].second << "\n";
+            for(int k = lastCDSIndex; k >= firstCDSIndex; --k){
+                writeExon(fw, ++i, exoncoord[k]);
             }
         }
-        return os;
+    }
+    static void writeExon(FileWriter& fw, int i, const std::pair<int, int>& exon){
+        fw.appendInt(i);
+        fw.appendChar(',');
+        fw.appendInt(exon.first);
+        fw.appendChar(',');
+        fw.appendInt(exon.second);
+        fw.appendChar('\n');
     }
 };
 
@@ -86,40 +113,34 @@ int main(int argc, char** argv){
     FileWriter fwriter = {std::string(argv[3])};
     std::vector<std::string> vtrs;
     util::makeListFromFileByLine(std::string(argv[2]), vtrs);
-    std::set<std::string> strs(vtrs.begin(), vtrs.end());
-    std::string line;
+    std::set<std::string, std::less<>> strs(vtrs.begin(), vtrs.end());
+    std::string_view line;
     freader.getline(line);
-    std::vector<std::string> vec;
-    std::ostringstream oss;
+    std::vector<std::string_view> vec;
+    std::vector<std::string_view> exonStart;
+    std::vector<std::string_view> exonEnd;
     while(freader.getline(line)){
-        util::split(line, vec, "\t");
+        util::splitView(line, vec, '\t', 18);
         if(strs.find(vec[1]) == strs.end()){
             continue;
         }
         ExonRecord rec;
         rec.trsName = vec[1];
-        rec.trsStart = std::atoi(vec[4].c_str());
-        rec.trsEnd = std::atoi(vec[5].c_str());
-        rec.cdsStart = std::atoi(vec[6].c_str());
-        rec.cdsEnd = std::atoi(vec[7].c_str());
+        rec.trsStart = util::str2num<int>(vec[4]);
+        rec.trsEnd = util::str2num<int>(vec[5]);
+        rec.cdsStart = util::str2num<int>(vec[6]);
+        rec.cdsEnd = util::str2num<int>(vec[7]);
         rec.strand = vec[3][0];
         rec.chromeName = vec[2];
         rec.geneName = vec[12];
         rec.trsVer = vec[16];
-        std::vector<std::string> exonStart;
-        std::vector<std::string> exonEnd;
-        util::split(vec[9], exonStart, ",");
-        util::split(vec[10], exonEnd, ",");
-        std::vector<int> startCoord;
-        std::vector<int> endCoord;
-        util::strvec2intvec(exonStart, startCoord);
-        util::strvec2intvec(exonEnd, endCoord);
-        util::vec2pairvec(startCoord, endCoord, rec.exoncoord);
+        util::splitView(vec[9], exonStart, ",");
+        util::splitView(vec[10], exonEnd, ",");
+        for(size_t i = 0; i < std::min(exonStart.size(), exonEnd.size()); ++i){
+            rec.exoncoord.push_back(std::make_pair(util::str2num<int>(exonStart[i]), util::str2num<int>(exonEnd[i])));
+        }
         rec.truncateByCDS();
-        oss.clear();
-        oss.str("");
-        oss << rec;
-        fwriter.writeString(oss.str());
+        rec.write(fwriter);
     }
 }
 
@@ -0,0 +1,32 @@
+#include <cstdio>
+#include <cstring>
+#include "pairedreader.h"
+
+int main(int argc, char *argv[])
+{
+	if (argc < 4) {
+		fprintf(stderr, "Usage: %s <fqr1> <fqr2> <readname>\n", argv[0]);
+		return 1;
+	}
+	char* pat = argv[3];
+	PairedReader reader(argv[1], argv[2], 4096, false);
+	SeqPairBatch batch;
+	while (reader.read(batch)) {
+		for (int i = 0; i < batch.n; ++i) {
+			const krec_t* seq1 = &batch.r1[i];
+			const krec_t* seq2 = &batch.r2[i];
+			if (strcmp(seq1->name.s, pat) == 0 && strcmp(seq2->name.s, pat) == 0) {
+				printf("read1:\n");
+				printf("name : %s\n", seq1->name.s);
+				printf("seq  : %s\n", seq1->seq.s);
+				printf("qual : %s\n", seq1->qual.s);
+				printf("read2:\n");
+				printf("name : %s\n", seq2->name.s);
+				printf("seq  : %s\n", seq2->seq.s);
+				printf("qual : %s\n", seq2->qual.s);
+				return 0;
+			}
+		}
+	}
+	return 0;
+}
@@ -1,46 +1,56 @@
-#include <kseq.h>
 #include <zlib.h>
 #include <iostream>
 #include <string>
 #include <fstream>
-#include <map>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include "kseq.h"
+#include "ntutil.h"
 
-KSEQ_INIT(gzFile, gzread)
-
-void statKmer(std::map<std::string, int32_t>& kcount, char* s, size_t l, int klen){
-    for(size_t i = 0; i < l - klen + 1; ++i){
-        std::string kmer(s + i, s + i + klen);
-        if(kcount.find(kmer) != kcount.end()){
-            ++kcount[kmer];
-        }else{
-            kcount[kmer] = 0;
-        }
-    }
+/** count k-mers of a sequence, lowercase bases are counted as uppercase and k-mers with non-ACGT bases are skipped
+ * @param kcount map from k-mer 2 bits code to its count
+ * @param s sequence
+ * @param l length of sequence
+ * @param klen k-mer length, 1 to 32
+ */
+void statKmer(std::unordered_map<uint64_t, int32_t>& kcount, const char* s, size_t l, int klen){
+    ntutil::forEachKmer(s, l, klen, [&](uint64_t code, size_t){
+        ++kcount[code];
+    });
 }
 
 int main(int argc, char** argv){
     if(argc <= 3){
         std::cout << argv[0] << " <infa> <kmerlen> <outf> " << std::endl;
+        std::cout << "k-mers are counted case-insensitively and output in uppercase, k-mers with non-ACGT bases are skipped" << std::endl;
         return 0;
     }
     char* infa = argv[1];
     int klen = std::atoi(argv[2]);
     char* outf = argv[3];
+    if(klen < 1 || klen > 32){
+        std::cerr << "kmerlen must be in range [1, 32]" << std::endl;
+        std::exit(1);
+    }
     std::ofstream fw(outf);
-    std::map<std::string, int32_t> kcount;
+    std::unordered_map<uint64_t, int32_t> kcount;
 
     gzFile fp = gzopen(infa, "r");
     kseq_t* seq = kseq_init(fp);
-    while(kseq_read(seq) >= 0){
-        char* s = seq->seq.s;
-        size_t l = seq->seq.l;
-        statKmer(kcount, s, l, klen);
+    krec_t* rec = krec_init();
+    while(kseq_read(seq, rec) >= 0){
+        statKmer(kcount, rec->seq.s, rec->seq.l, klen);
     }
-    for(auto& e: kcount){
-        fw << e.first << " " << e.second << "\n";
+    // 2 bits codes sort the same way as ACGT strings
+    std::vector<std::pair<uint64_t, int32_t>> sorted(kcount.begin(), kcount.end());
+    std::sort(sorted.begin(), sorted.end());
+    for(auto& e: sorted){
+        fw << ntutil::decodeKmer(e.first, klen) << " " << e.second << "\n";
     }
     fw.close();
-        
-    gzclose(fp);
+
+    krec_destroy(rec);
     kseq_destroy(seq);
+    gzclose(fp);
 }
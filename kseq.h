@@ -11,6 +11,12 @@
 #define KS_SEP_LINE  2 // line separator: "\n" (Unix) or "\r\n" (Windows)
 #define KS_SEP_MAX   2
 
+/* default size of kstream buffer, define it before including kseq.h to change it,
+   or use KSEQ_INIT3 to give buffer size of each stream type */
+#ifndef KSEQ_BUFSIZE
+#define KSEQ_BUFSIZE 131072
+#endif
+
 #define __KS_TYPE(type_t)						\
 	typedef struct __kstream_t {				\
 		unsigned char *buf;						\
@@ -81,12 +87,9 @@ typedef struct __kstring_t {
 					if (ks->end == -1) { ks->is_eof = 1; return -3; }	\
 				} else break;											\
 			}															\
-			if (delimiter == KS_SEP_LINE) { \
-				for (i = ks->begin; i < ks->end; ++i) \
-					if (ks->buf[i] == '\n') break; \
-			} else if (delimiter > KS_SEP_MAX) {						\
-				for (i = ks->begin; i < ks->end; ++i)					\
-					if (ks->buf[i] == delimiter) break;					\
+			if (delimiter == KS_SEP_LINE || delimiter > KS_SEP_MAX) { /* memchr scans with SIMD */ \
+				unsigned char *p = (unsigned char*)memchr(ks->buf + ks->begin, delimiter == KS_SEP_LINE ? '\n' : delimiter, ks->end - ks->begin); \
+				i = p ? (int)(p - ks->buf) : ks->end; \
 			} else if (delimiter == KS_SEP_SPACE) {						\
 				for (i = ks->begin; i < ks->end; ++i)					\
 					if (isspace(ks->buf[i])) break;						\
@@ -201,6 +204,41 @@ typedef struct __kstring_t {
 		return rec->seq.l; \
 	}
 
+/* Read up to n records into recs, stop early once max_bytes(0 for no limit) of
+   name, comment, sequence and quality have been read.
+   Return value:
+   >=0  number of records read, 0 at end-of-file
+   -2   truncated quality string in the first record
+   -3   error reading stream before any record read
+   *ret is set to the return value of the last kseq_read call if ret is not NULL,
+   so an error after some records is reported with the records read
+ */
+#define __KSEQ_READ_BATCH(SCOPE) \
+	SCOPE inline krec_t *krecs_init(int n) \
+	{ \
+		return (krec_t*)calloc(n, sizeof(krec_t)); \
+	} \
+	SCOPE inline void krecs_destroy(krec_t *recs, int n) \
+	{ \
+		int i; \
+		if (!recs) return; \
+		for (i = 0; i < n; ++i) { \
+			free(recs[i].name.s); free(recs[i].comment.s); free(recs[i].seq.s); free(recs[i].qual.s); \
+		} \
+		free(recs); \
+	} \
+	SCOPE inline int kseq_read_batch(kseq_t *seq, krec_t *recs, int n, size_t max_bytes, int *ret) \
+	{ \
+		int i, r = 0; \
+		size_t bytes = 0; \
+		for (i = 0; i < n && (max_bytes == 0 || bytes < max_bytes); ++i) { \
+			if ((r = kseq_read(seq, &recs[i])) < 0) break; \
+			bytes += recs[i].name.l + recs[i].comment.l + recs[i].seq.l + recs[i].qual.l; \
+		} \
+		if (ret) *ret = r; \
+		return (i == 0 && r < -1) ? r : i; \
+	}
+
 #define __KSEQ_TYPE(type_t)						\
 	typedef struct {							\
 		int last_char;							\
@@ -212,13 +250,16 @@ typedef struct __kstring_t {
             kstring_t name, comment, seq, qual;     \
         } krec_t;                              \
 
-#define KSEQ_INIT2(SCOPE, type_t, __read)		\
-	KSTREAM_INIT(type_t, __read, 16384)			\
+#define KSEQ_INIT3(SCOPE, type_t, __read, __bufsize)	\
+	KSTREAM_INIT(type_t, __read, __bufsize)		\
 	__KSEQ_TYPE(type_t)							\
 	__KSEQ_BASIC(SCOPE, type_t)					\
-	__KSEQ_READ(SCOPE)
+	__KSEQ_READ(SCOPE)							\
+	__KSEQ_READ_BATCH(SCOPE)
         __KREC_TYPE(type_t)                              \
 
+#define KSEQ_INIT2(SCOPE, type_t, __read) KSEQ_INIT3(SCOPE, type_t, __read, KSEQ_BUFSIZE)
+
 #define KSEQ_INIT(type_t, __read) KSEQ_INIT2(static, type_t, __read)
 
 #define KSEQ_DECLARE(type_t) \
@@ -226,7 +267,10 @@ typedef struct __kstring_t {
 	__KSEQ_TYPE(type_t) \
 	extern kseq_t *kseq_init(type_t fd); \
 	void kseq_destroy(kseq_t *ks); \
-	int kseq_read(kseq_t *seq, krec_t* rec);
+	int kseq_read(kseq_t *seq, krec_t* rec); \
+	krec_t *krecs_init(int n); \
+	void krecs_destroy(krec_t *recs, int n); \
+	int kseq_read_batch(kseq_t *seq, krec_t *recs, int n, size_t max_bytes, int *ret);
 
 KSEQ_INIT(gzFile, gzread);
 
@@ -0,0 +1,78 @@
+#ifndef LINEPROCESSOR_H
+#define LINEPROCESSOR_H
+
+#include <string>
+#include <string_view>
+#include "filereader.h"
+#include "orderedpool.h"
+
+/** Class to process lines of a FileReader in parallel\n
+ * the input is split into newline aligned chunks, which are dispatched to a pool of worker threads,\n
+ * results of each chunk are handed to a sink serially, either in input order or in finishing order
+ */
+class LineProcessor{
+    FileReader* mReader;                                  ///< pointer to FileReader to read lines from
+    int mThreads;                                         ///< number of worker threads
+    bool mOrdered;                                        ///< hand results to sink in input order if true
+    size_t mChunkSize;                                    ///< minimum Bytes of lines in each chunk
+    size_t mMaxChunks;                                    ///< maximum chunks read but not yet handed to sink
+
+    public:
+    /** Construct a LineProcessor
+     * @param reader pointer to FileReader to read lines from
+     * @param threads number of worker threads
+     * @param ordered hand results to sink in input order if true
+     * @param chunkSize minimum Bytes of lines in each chunk
+     */
+    LineProcessor(FileReader* reader, int threads, bool ordered = true, size_t chunkSize = (1 << 22)){
+        mReader = reader;
+        mThreads = std::max(1, threads);
+        mOrdered = ordered;
+        mChunkSize = chunkSize;
+        mMaxChunks = mThreads * 4;
+    }
+
+    /** call f on each line in chunk, line breaks("\n", "\r" or "\r\n") are not included
+     * @param chunk lines read by FileReader::getChunk
+     * @param f function called as f(std::string_view line)
+     */
+    template<typename F>
+    inline static void forEachLine(const std::string& chunk, F&& f){
+        const char* beg = chunk.data();
+        const char* end = beg + chunk.size();
+        while(beg < end){
+            const char* pos = FileReader::findLineBreak(beg, end);
+            f(std::string_view(beg, pos - beg));
+            if(pos < end - 1 && pos[0] == '\r' && pos[1] == '\n'){
+                ++pos;
+            }
+            beg = pos + 1;
+        }
+    }
+
+    /** process all lines left in reader, the calling thread reads chunks while worker threads process them
+     * @param work function called in worker threads as work(std::string_view line, R& result) for each line
+     * @param sink function called serially as sink(R& result) once for each chunk
+     * @tparam R result type of a chunk, a default constructed R is used for each chunk
+     */
+    template<typename R, typename W, typename S>
+    inline void run(W work, S sink){
+        OrderedPool<std::string, R> pool(mOrdered);
+        pool.start(mThreads, mMaxChunks, [&](std::string& chunk, R& result){
+            forEachLine(chunk, [&](std::string_view line){work(line, result);});
+        }, [&](std::string&, R& result){
+            sink(result);
+        });
+        std::string chunk;
+        while(true){
+            pool.acquire(chunk);
+            if(!mReader->getChunk(chunk, mChunkSize)){
+                break;
+            }
+            pool.submit(std::move(chunk));
+        }
+        pool.finish();
+    }
+};
+
+#endif
@@ -0,0 +1,26 @@
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <string>
+#include "seqpipeline.h"
+
+int main(int argc, char** argv){
+    if(argc < 3){
+        std::printf("%s <in.fq> <seq> [threads]\n", argv[0]);
+        return 0;
+    }
+    char* qseq = argv[2];
+    int threads = argc > 3 ? std::atoi(argv[3]) : 1;
+    SeqPipeline sp(argv[1], threads);
+    bool ok = sp.run<std::string>([&](const krec_t* recs, int n, std::string& out){
+        for(int i = 0; i < n; ++i){
+            if(std::strstr(recs[i].seq.s, qseq)){
+                out.append(recs[i].seq.s, recs[i].seq.l);
+                out.push_back('\n');
+            }
+        }
+    }, [](std::string& out){
+        std::fwrite(out.data(), 1, out.size(), stdout);
+    });
+    return ok ? 0 : 1;
+}
@@ -26,11 +26,12 @@ int main(int argc, char** argv){
     BGZF* ifp = bgzf_open(argv[1], "rb");
     kstring_t str = {0, 0, 0};
     std::vector<std::string> gvstr;
+    std::string quoted, trsid;
     while(bgzf_getline(ifp, '\n', &str) >= 0){
         util::split(str.s, vstr, "\t");
         util::split(vstr[8], gvstr, " ");
-        std::string trsid = util::replace(gvstr[1], "\"", "");
-        trsid = util::replace(trsid, ";", "");
+        util::replace(gvstr[1], "\"", "", quoted);
+        util::replace(quoted, ";", "", trsid);
         gvstr[0] = "gene_name";
         gvstr[1] = "\"" + tr2gn[trsid] + "\";";
         std::string gnstr;
@@ -0,0 +1,600 @@
+#ifndef NTUTIL_H
+#define NTUTIL_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cctype>
+#include <algorithm>
+#include "util.h"
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define NTUTIL_X86_SIMD
+#endif
+
+/** nucleotide encoding and decoding utilities, see ATCG.Binary for the bits behind them\n
+ * nt4 codes A/C/G/T as 0/1/2/3 and any other base as 4, 2 bits packed nt4 puts the first base in the highest bits like bwa pac\n
+ * nt16 is the 4 bits IUPAC code used by BAM, where A/C/G/T/N are 1/2/4/8/15 and the first base is in the high nibble
+ */
+namespace ntutil{
+    /** nt16 code to base characters */
+    static const char NT16_STR[] = "=ACMGRSVTWYHKDBN";
+
+    /** nt4 code to base characters */
+    static const char NT4_STR[] = "ACGTN";
+
+    /** get table to convert a base character to nt4 code, case insensitive
+     * @return pointer to table of 256 entries
+     */
+    inline const uint8_t* getNt4Table(){
+        static const struct Nt4Table{
+            uint8_t t[256];
+            Nt4Table(){
+                std::memset(t, 4, 256);
+                for(int i = 0; i < 4; ++i){
+                    t[(uint8_t)NT4_STR[i]] = t[(uint8_t)std::tolower(NT4_STR[i])] = i;
+                }
+            }
+        } table;
+        return table.t;
+    }
+
+    /** get table to convert a base character to nt16 code, case insensitive, the same as seq_nt16_table of htslib
+     * @return pointer to table of 256 entries
+     */
+    inline const uint8_t* getNt16Table(){
+        static const struct Nt16Table{
+            uint8_t t[256];
+            Nt16Table(){
+                std::memset(t, 15, 256);
+                for(int i = 0; i < 16; ++i){
+                    t[(uint8_t)NT16_STR[i]] = t[(uint8_t)std::tolower(NT16_STR[i])] = i;
+                }
+                t[(uint8_t)'U'] = t[(uint8_t)'u'] = 8;
+            }
+        } table;
+        return table.t;
+    }
+
+    /** convert a nt16 code to nt4 code
+     * @param c nt16 code
+     * @return nt4 code, 4 if c is not one of A/C/G/T
+     */
+    inline uint8_t nt16ToNt4(uint8_t c){
+        static const uint8_t table[16] = {4, 0, 1, 4, 2, 4, 4, 4, 3, 4, 4, 4, 4, 4, 4, 4};
+        return table[c & 0xf];
+    }
+
+    /** convert a nt4 code to nt16 code
+     * @param c nt4 code
+     * @return nt16 code, 15 if c is not one of A/C/G/T
+     */
+    inline uint8_t nt4ToNt16(uint8_t c){
+        static const uint8_t table[5] = {1, 2, 4, 8, 15};
+        return table[c < 4 ? c : 4];
+    }
+
+    /** convert bases to nt4 codes one base at a time
+     * @param seq base characters
+     * @param len number of bases
+     * @param out nt4 codes of len Bytes, can be the same as seq
+     */
+    inline void encodeNt4Scalar(const char* seq, size_t len, uint8_t* out){
+        const uint8_t* table = getNt4Table();
+        for(size_t i = 0; i < len; ++i){
+            out[i] = table[(uint8_t)seq[i]];
+        }
+    }
+
+    /** convert bases to packed nt16 codes one base at a time
+     * @param seq base characters
+     * @param len number of bases
+     * @param out packed nt16 codes of (len + 1) / 2 Bytes, the low nibble of last Byte is 0 if len is odd
+     */
+    inline void encodeNt16Scalar(const char* seq, size_t len, uint8_t* out){
+        const uint8_t* table = getNt16Table();
+        size_t i = 0;
+        for(; i + 1 < len; i += 2){
+            out[i >> 1] = table[(uint8_t)seq[i]] << 4 | table[(uint8_t)seq[i + 1]];
+        }
+        if(i < len){
+            out[i >> 1] = table[(uint8_t)seq[i]] << 4;
+        }
+    }
+
+#ifdef NTUTIL_X86_SIMD
+    /** convert 16 bases to nt4 or nt16 codes, ACGT and N are looked up by low 4 bits of uppercased bases
+     * @param v 16 bases
+     * @param nt16 convert to nt16 codes if true, else nt4 codes
+     * @param ok set to false if nt16 and any base is not ACGTN, the result is invalid then
+     * @return codes, one per Byte
+     */
+    __attribute__((target("ssse3")))
+    inline __m128i encodeBlockSSSE3(__m128i v, bool nt16, bool& ok){
+        const __m128i fwd = _mm_setr_epi8(-1, 'A', -1, 'C', 'T', -1, -1, 'G', -1, -1, -1, -1, -1, -1, nt16 ? 'N' : -1, -1);
+        const __m128i codes = nt16 ? _mm_setr_epi8(0, 1, 0, 2, 8, 0, 0, 4, 0, 0, 0, 0, 0, 0, 15, 0) :
+                                     _mm_setr_epi8(0, 0, 0, 1, 3, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0);
+        __m128i upper = _mm_and_si128(v, _mm_set1_epi8((char)0xdf));
+        __m128i idx = _mm_and_si128(upper, _mm_set1_epi8(0x0f));
+        __m128i hit = _mm_cmpeq_epi8(_mm_shuffle_epi8(fwd, idx), upper);
+        __m128i c = _mm_shuffle_epi8(codes, idx);
+        if(nt16){
+            ok = _mm_movemask_epi8(hit) == 0xffff;
+            return c;
+        }
+        ok = true;
+        return _mm_or_si128(_mm_and_si128(hit, c), _mm_andnot_si128(hit, _mm_set1_epi8(4)));
+    }
+
+    /** convert bases to nt4 codes 16 bases at a time
+     * @param seq base characters
+     * @param len number of bases
+     * @param out nt4 codes of len Bytes, can be the same as seq
+     */
+    __attribute__((target("ssse3")))
+    inline void encodeNt4SSSE3(const char* seq, size_t len, uint8_t* out){
+        size_t i = 0;
+        bool ok = true;
+        for(; i + 16 <= len; i += 16){
+            _mm_storeu_si128((__m128i*)(out + i), encodeBlockSSSE3(_mm_loadu_si128((const __m128i*)(seq + i)), false, ok));
+        }
+        encodeNt4Scalar(seq + i, len - i, out + i);
+    }
+
+    /** convert bases to packed nt16 codes 16 bases at a time, blocks with bases other than ACGTN are converted by table
+     * @param seq base characters
+     * @param len number of bases
+     * @param out packed nt16 codes of (len + 1) / 2 Bytes
+     */
+    __attribute__((target("ssse3")))
+    inline void encodeNt16SSSE3(const char* seq, size_t len, uint8_t* out){
+        size_t i = 0;
+        for(; i + 16 <= len; i += 16){
+            bool ok = true;
+            __m128i c = encodeBlockSSSE3(_mm_loadu_si128((const __m128i*)(seq + i)), true, ok);
+            if(!ok){
+                encodeNt16Scalar(seq + i, 16, out + (i >> 1));
+                continue;
+            }
+            // the first base of each pair goes to the high nibble
+            __m128i packed = _mm_maddubs_epi16(c, _mm_set1_epi16(0x0110));
+            _mm_storel_epi64((__m128i*)(out + (i >> 1)), _mm_packus_epi16(packed, packed));
+        }
+        encodeNt16Scalar(seq + i, len - i, out + (i >> 1));
+    }
+
+    /** convert 32 bases to nt4 or nt16 codes, see encodeBlockSSSE3
+     * @param v 32 bases
+     * @param nt16 convert to nt16 codes if true, else nt4 codes
+     * @param ok set to false if nt16 and any base is not ACGTN, the result is invalid then
+     * @return codes, one per Byte
+     */
+    __attribute__((target("avx2")))
+    inline __m256i encodeBlockAVX2(__m256i v, bool nt16, bool& ok){
+        const char n = nt16 ? 'N' : -1;
+        const __m256i fwd = _mm256_setr_epi8(-1, 'A', -1, 'C', 'T', -1, -1, 'G', -1, -1, -1, -1, -1, -1, n, -1,
+                                             -1, 'A', -1, 'C', 'T', -1, -1, 'G', -1, -1, -1, -1, -1, -1, n, -1);
+        const __m256i codes = nt16 ? _mm256_setr_epi8(0, 1, 0, 2, 8, 0, 0, 4, 0, 0, 0, 0, 0, 0, 15, 0,
+                                                      0, 1, 0, 2, 8, 0, 0, 4, 0, 0, 0, 0, 0, 0, 15, 0) :
+                                     _mm256_setr_epi8(0, 0, 0, 1, 3, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0,
+                                                      0, 0, 0, 1, 3, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0);
+        __m256i upper = _mm256_and_si256(v, _mm256_set1_epi8((char)0xdf));
+        __m256i idx = _mm256_and_si256(upper, _mm256_set1_epi8(0x0f));
+        __m256i hit = _mm256_cmpeq_epi8(_mm256_shuffle_epi8(fwd, idx), upper);
+        __m256i c = _mm256_shuffle_epi8(codes, idx);
+        if(nt16){
+            ok = (uint32_t)_mm256_movemask_epi8(hit) == 0xffffffffu;
+            return c;
+        }
+        ok = true;
+        return _mm256_blendv_epi8(_mm256_set1_epi8(4), c, hit);
+    }
+
+    /** convert bases to nt4 codes 32 bases at a time
+     * @param seq base characters
+     * @param len number of bases
+     * @param out nt4 codes of len Bytes, can be the same as seq
+     */
+    __attribute__((target("avx2")))
+    inline void encodeNt4AVX2(const char* seq, size_t len, uint8_t* out){
+        size_t i = 0;
+        bool ok = true;
+        for(; i + 32 <= len; i += 32){
+            _mm256_storeu_si256((__m256i*)(out + i), encodeBlockAVX2(_mm256_loadu_si256((const __m256i*)(seq + i)), false, ok));
+        }
+        encodeNt4SSSE3(seq + i, len - i, out + i);
+    }
+
+    /** convert bases to packed nt16 codes 32 bases at a time, blocks with bases other than ACGTN are converted by table
+     * @param seq base characters
+     * @param len number of bases
+     * @param out packed nt16 codes of (len + 1) / 2 Bytes
+     */
+    __attribute__((target("avx2")))
+    inline void encodeNt16AVX2(const char* seq, size_t len, uint8_t* out){
+        size_t i = 0;
+        for(; i + 32 <= len; i += 32){
+            bool ok = true;
+            __m256i c = encodeBlockAVX2(_mm256_loadu_si256((const __m256i*)(seq + i)), true, ok);
+            if(!ok){
+                encodeNt16Scalar(seq + i, 32, out + (i >> 1));
+                continue;
+            }
+            __m256i packed = _mm256_maddubs_epi16(c, _mm256_set1_epi16(0x0110));
+            packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(packed, packed), 0x08);
+            _mm_storeu_si128((__m128i*)(out + (i >> 1)), _mm256_castsi256_si128(packed));
+        }
+        encodeNt16SSSE3(seq + i, len - i, out + (i >> 1));
+    }
+
+#endif
+
+    /** convert bases to nt4 codes with the fastest kernel supported by cpu at runtime
+     * @param seq base characters
+     * @param len number of bases
+     * @param out nt4 codes of len Bytes, can be the same as seq
+     */
+    inline void encodeNt4(const char* seq, size_t len, uint8_t* out){
+#ifdef NTUTIL_X86_SIMD
+        if(util::getSimdLevel() == 2){
+            return encodeNt4AVX2(seq, len, out);
+        }
+        if(util::getSimdLevel() == 1){
+            return encodeNt4SSSE3(seq, len, out);
+        }
+#endif
+        encodeNt4Scalar(seq, len, out);
+    }
+
+    /** convert bases to packed nt16 codes with the fastest kernel supported by cpu at runtime, as BAM stores sequence
+     * @param seq base characters
+     * @param len number of bases
+     * @param out packed nt16 codes of (len + 1) / 2 Bytes
+     */
+    inline void encodeNt16(const char* seq, size_t len, uint8_t* out){
+#ifdef NTUTIL_X86_SIMD
+        if(util::getSimdLevel() == 2){
+            return encodeNt16AVX2(seq, len, out);
+        }
+        if(util::getSimdLevel() == 1){
+            return encodeNt16SSSE3(seq, len, out);
+        }
+#endif
+        encodeNt16Scalar(seq, len, out);
+    }
+
+    /** convert packed nt16 codes to bases, two bases at a time
+     * @param data packed nt16 codes
+     * @param len number of bases
+     * @param out base characters of len Bytes
+     */
+    inline void decodeNt16(const uint8_t* data, size_t len, char* out){
+        static const struct Nt16PairTable{
+            char t[256][2];
+            Nt16PairTable(){
+                for(int i = 0; i < 256; ++i){
+                    t[i][0] = NT16_STR[i >> 4];
+                    t[i][1] = NT16_STR[i & 0xf];
+                }
+            }
+        } table;
+        size_t i = 0;
+        for(; i + 1 < len; i += 2){
+            std::memcpy(out + i, table.t[data[i >> 1]], 2);
+        }
+        if(i < len){
+            out[i] = table.t[data[i >> 1]][0];
+        }
+    }
+
+    /** pack bases to 2 bits nt4 codes, bases other than ACGT are stored as A and marked in nmask
+     * @param seq base characters
+     * @param len number of bases
+     * @param pac packed codes of (len + 3) / 4 Bytes, the first base is in the highest bits
+     * @param nmask bit mask of (len + 63) / 64 words to mark non-ACGT bases if not NULL, bit i % 64 of word i / 64 for base i
+     * @return number of non-ACGT bases
+     */
+    inline size_t packNt4(const char* seq, size_t len, uint8_t* pac, uint64_t* nmask = NULL){
+        uint8_t codes[256];
+        size_t nn = 0;
+        if(nmask){
+            std::memset(nmask, 0, ((len + 63) >> 6) << 3);
+        }
+        for(size_t beg = 0; beg < len; beg += 256){
+            size_t n = std::min(len - beg, (size_t)256);
+            encodeNt4(seq + beg, n, codes);
+            for(size_t i = 0; i < n; ++i){
+                if(codes[i] > 3){
+                    codes[i] = 0;
+                    ++nn;
+                    if(nmask){
+                        nmask[(beg + i) >> 6] |= 1ULL << ((beg + i) & 63);
+                    }
+                }
+            }
+            std::memset(codes + n, 0, (4 - (n & 3)) & 3);
+            for(size_t i = 0; i < n; i += 4){
+                pac[(beg + i) >> 2] = codes[i] << 6 | codes[i + 1] << 4 | codes[i + 2] << 2 | codes[i + 3];
+            }
+        }
+        return nn;
+    }
+
+    /** unpack 2 bits nt4 codes to bases, four bases at a time
+     * @param pac packed codes, the first base is in the highest bits
+     * @param len number of bases
+     * @param out base characters of len Bytes
+     * @param nmask bit mask of non-ACGT bases from packNt4, which are unpacked as N, ignored if NULL
+     */
+    inline void unpackNt4(const uint8_t* pac, size_t len, char* out, const uint64_t* nmask = NULL){
+        static const struct UnpackTable{
+            char t[256][4];
+            UnpackTable(){
+                for(int i = 0; i < 256; ++i){
+                    for(int j = 0; j < 4; ++j){
+                        t[i][j] = NT4_STR[i >> ((3 - j) << 1) & 3];
+                    }
+                }
+            }
+        } table;
+        size_t i = 0;
+        for(; i + 4 <= len; i += 4){
+            std::memcpy(out + i, table.t[pac[i >> 2]], 4);
+        }
+        if(i < len){
+            std::memcpy(out + i, table.t[pac[i >> 2]], len - i);
+        }
+        if(nmask){
+            for(size_t w = 0; w < ((len + 63) >> 6); ++w){
+                for(uint64_t m = nmask[w]; m; m &= m - 1){
+                    out[(w << 6) + __builtin_ctzll(m)] = 'N';
+                }
+            }
+        }
+    }
+
+    /** Structure to hold base composition of a sequence, case insensitive */
+    struct BaseComposition{
+        uint64_t cnt[5] = {0, 0, 0, 0, 0}; ///< number of A/C/G/T and all other bases, indexed by nt4 code
+
+        /** get number of all bases
+         * @return number of all bases
+         */
+        inline uint64_t total() const {
+            return cnt[0] + cnt[1] + cnt[2] + cnt[3] + cnt[4];
+        }
+
+        /** get GC ratio to all bases, non-ACGT bases included
+         * @return GC ratio, 0 if no bases
+         */
+        inline double gcRatio() const {
+            uint64_t tot = total();
+            return tot ? double(cnt[1] + cnt[2]) / tot : 0.0;
+        }
+    };
+
+    /** count bases one base at a time
+     * @param seq base characters
+     * @param len number of bases
+     * @param comp BaseComposition to add counts to
+     */
+    inline void countBasesScalar(const char* seq, size_t len, BaseComposition& comp){
+        const uint8_t* table = getNt4Table();
+        for(size_t i = 0; i < len; ++i){
+            ++comp.cnt[table[(uint8_t)seq[i]]];
+        }
+    }
+
+#ifdef NTUTIL_X86_SIMD
+    /** count bases 16 bases at a time, per Byte counters are summed up every 255 iterations before they overflow
+     * @param seq base characters
+     * @param len number of bases
+     * @param comp BaseComposition to add counts to
+     */
+    __attribute__((target("sse2")))
+    inline void countBasesSSE2(const char* seq, size_t len, BaseComposition& comp){
+        const char* bases = NT4_STR;
+        const __m128i zero = _mm_setzero_si128();
+        size_t i = 0;
+        size_t acgt = 0;
+        while(i + 16 <= len){
+            __m128i acc[4] = {zero, zero, zero, zero};
+            size_t blockEnd = std::min(i + 16 * 255, len - ((len - i) & 15));
+            for(; i < blockEnd; i += 16){
+                __m128i v = _mm_and_si128(_mm_loadu_si128((const __m128i*)(seq + i)), _mm_set1_epi8((char)0xdf));
+                for(int k = 0; k < 4; ++k){
+                    acc[k] = _mm_sub_epi8(acc[k], _mm_cmpeq_epi8(v, _mm_set1_epi8(bases[k])));
+                }
+            }
+            for(int k = 0; k < 4; ++k){
+                uint64_t sum[2];
+                _mm_storeu_si128((__m128i*)sum, _mm_sad_epu8(acc[k], zero));
+                uint64_t n = sum[0] + sum[1];
+                comp.cnt[k] += n;
+                acgt += n;
+            }
+        }
+        comp.cnt[4] += i - acgt;
+        countBasesScalar(seq + i, len - i, comp);
+    }
+
+    /** count bases 32 bases at a time, see countBasesSSE2
+     * @param seq base characters
+     * @param len number of bases
+     * @param comp BaseComposition to add counts to
+     */
+    __attribute__((target("avx2")))
+    inline void countBasesAVX2(const char* seq, size_t len, BaseComposition& comp){
+        const char* bases = NT4_STR;
+        const __m256i zero = _mm256_setzero_si256();
+        size_t i = 0;
+        size_t acgt = 0;
+        while(i + 32 <= len){
+            __m256i acc[4] = {zero, zero, zero, zero};
+            size_t blockEnd = std::min(i + 32 * 255, len - ((len - i) & 31));
+            for(; i < blockEnd; i += 32){
+                __m256i v = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(seq + i)), _mm256_set1_epi8((char)0xdf));
+                for(int k = 0; k < 4; ++k){
+                    acc[k] = _mm256_sub_epi8(acc[k], _mm256_cmpeq_epi8(v, _mm256_set1_epi8(bases[k])));
+                }
+            }
+            for(int k = 0; k < 4; ++k){
+                uint64_t sum[4];
+                _mm256_storeu_si256((__m256i*)sum, _mm256_sad_epu8(acc[k], zero));
+                uint64_t n = sum[0] + sum[1] + sum[2] + sum[3];
+                comp.cnt[k] += n;
+                acgt += n;
+            }
+        }
+        comp.cnt[4] += i - acgt;
+        countBasesSSE2(seq + i, len - i, comp);
+    }
+#endif
+
+    /** count bases with the fastest kernel supported by cpu at runtime,\n
+     * SSE2 is part of the x86-64 baseline so it is used unless util::getSimdLevel reports AVX2
+     * @param seq base characters
+     * @param len number of bases
+     * @return base composition of seq
+     */
+    inline BaseComposition countBases(const char* seq, size_t len){
+        BaseComposition comp;
+#ifdef NTUTIL_X86_SIMD
+        if(util::getSimdLevel() == 2){
+            countBasesAVX2(seq, len, comp);
+            return comp;
+        }
+#ifdef __SSE2__
+        countBasesSSE2(seq, len, comp);
+        return comp;
+#endif
+#endif
+        countBasesScalar(seq, len, comp);
+        return comp;
+    }
+
+    /** get GC ratio of windows starting every step bases over a sequence, the last window may be shorter
+     * @param seq base characters
+     * @param len number of bases
+     * @param window window size
+     * @param step distance between starts of adjacent windows, window size is used if 0
+     * @param gc store GC ratio of each window, non-ACGT bases included in denominator
+     */
+    inline void windowGC(const char* seq, size_t len, size_t window, size_t step, std::vector<double>& gc){
+        gc.clear();
+        if(window == 0){
+            return;
+        }
+        if(step == 0){
+            step = window;
+        }
+        gc.reserve(len / step + 1);
+        for(size_t beg = 0; beg < len; beg += step){
+            gc.push_back(countBases(seq + beg, std::min(window, len - beg)).gcRatio());
+            if(beg + window >= len){
+                break;
+            }
+        }
+    }
+
+    /** get hamming distance of two 2 bits packed sequences, 32 bases a time by XOR and popcount\n
+     * non-ACGT bases are packed as A by packNt4, so use nmask to treat them differently
+     * @param pac1 packed sequence 1 from packNt4
+     * @param pac2 packed sequence 2 from packNt4
+     * @param len number of bases
+     * @return number of bases with different codes
+     */
+    inline size_t hammingNt4(const uint8_t* pac1, const uint8_t* pac2, size_t len){
+        const uint64_t lo = 0x5555555555555555ULL;
+        size_t bytes = (len + 3) >> 2;
+        size_t diff = 0;
+        size_t i = 0;
+        for(; i + 8 <= bytes; i += 8){
+            uint64_t w1, w2;
+            std::memcpy(&w1, pac1 + i, 8);
+            std::memcpy(&w2, pac2 + i, 8);
+            uint64_t x = w1 ^ w2;
+            diff += __builtin_popcountll((x | x >> 1) & lo);
+        }
+        if(i < bytes){
+            uint64_t w1 = 0, w2 = 0;
+            std::memcpy(&w1, pac1 + i, bytes - i);
+            std::memcpy(&w2, pac2 + i, bytes - i);
+            uint64_t x = w1 ^ w2;
+            diff += __builtin_popcountll((x | x >> 1) & lo);
+        }
+        // bits after the last base may differ if packed sequences are not zero padded
+        if(len & 3){
+            uint8_t x = (pac1[bytes - 1] ^ pac2[bytes - 1]) & ((1 << ((4 - (len & 3)) << 1)) - 1);
+            diff -= __builtin_popcount((x | x >> 1) & 0x55);
+        }
+        return diff;
+    }
+
+    /** get hamming distances of a 2 bits packed query to many packed targets of the same length, like a barcode whitelist
+     * @param query packed query from packNt4
+     * @param targets packed targets stored one after another, each takes (len + 3) / 4 Bytes
+     * @param n number of targets
+     * @param len number of bases of query and each target
+     * @param dists store n hamming distances
+     * @return index of the first target with the smallest distance, -1 if n is 0
+     */
+    inline int hammingNt4(const uint8_t* query, const uint8_t* targets, size_t n, size_t len, int* dists){
+        size_t stride = (len + 3) >> 2;
+        int best = -1;
+        for(size_t i = 0; i < n; ++i){
+            dists[i] = hammingNt4(query, targets + i * stride, len);
+            if(best < 0 || dists[i] < dists[best]){
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    /** call a function for each k-mer without non-ACGT bases, k-mers are hashed to 2 bits codes incrementally
+     * @param seq base characters
+     * @param len number of bases
+     * @param k k-mer length, 1 to 32
+     * @param f function called as f(uint64_t code, size_t pos), code has the first base in the highest bits
+     * and pos is the offset of the first base of k-mer
+     * @return number of k-mers
+     */
+    template<typename F>
+    inline size_t forEachKmer(const char* seq, size_t len, int k, F f){
+        const uint8_t* table = getNt4Table();
+        const uint64_t mask = k < 32 ? (1ULL << (k << 1)) - 1 : ~0ULL;
+        uint64_t code = 0;
+        size_t n = 0;
+        int valid = 0;
+        for(size_t i = 0; i < len; ++i){
+            uint8_t c = table[(uint8_t)seq[i]];
+            if(c > 3){
+                valid = 0;
+                code = 0;
+                continue;
+            }
+            code = (code << 2 | c) & mask;
+            if(++valid >= k){
+                f(code, i + 1 - k);
+                ++n;
+            }
+        }
+        return n;
+    }
+
+    /** convert a k-mer code to bases
+     * @param code k-mer code from forEachKmer
+     * @param k k-mer length
+     * @return k-mer bases
+     */
+    inline std::string decodeKmer(uint64_t code, int k){
+        std::string s(k, 'A');
+        for(int i = k - 1; i >= 0; --i, code >>= 2){
+            s[i] = NT4_STR[code & 3];
+        }
+        return s;
+    }
+}
+
+#endif
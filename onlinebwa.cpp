@@ -69,12 +69,16 @@ bwt_t* OnlineBWA::pac2bwt(const uint8_t* pac, int bwt_seq_lenr){
 }
 
 void OnlineBWA::addAnns(const std::string& name, const std::string& seq, bntann1_t* ann, size_t offset){
+    addAnns(name, seq.length(), ann, offset);
+}
+
+void OnlineBWA::addAnns(const std::string& name, size_t len, bntann1_t* ann, size_t offset){
     ann->offset = offset;
     ann->name = (char*)std::malloc(name.length() + 1);
     std::strncpy(ann->name, name.c_str(), name.length() + 1);
     ann->anno = (char*)std::malloc(7);
     std::strncpy(ann->anno, "(null)\0", 7);
-    ann->len = seq.length();
+    ann->len = len;
     ann->n_ambs = 0;
     ann->gi = 0;
     ann->is_alt = 0;
@@ -114,12 +118,12 @@ uint8_t* OnlineBWA::addSeq2pac(const kseq_t* seq, bntseq_t* bns, uint8_t* pac, i
         lasts = seq->seq.s[i];
         if (c >= 4) c = lrand48()&3;
         if (bns->l_pac == *m_pac) { // double the pac size
-        *m_pac <<= 1;
-        pac = (uint8_t*)realloc(pac, *m_pac/4);
-        memset(pac + bns->l_pac/4, 0, (*m_pac - bns->l_pac)/4);
+            *m_pac <<= 1;
+            pac = (uint8_t*)realloc(pac, *m_pac/4);
+            memset(pac + bns->l_pac/4, 0, (*m_pac - bns->l_pac)/4);
+        }
         _set_pac(pac, bns->l_pac, c);
         ++bns->l_pac;
-        }
     }
     ++bns->n_seqs;
     return pac;
@@ -178,6 +182,33 @@ uint8_t* OnlineBWA::makePac(std::vector<UnalignedSeq> v, bool addReverse){
     return pac;
 }
 
+uint8_t* OnlineBWA::makePac(const std::vector<PackedSeq>& v, bool addReverse){
+    int64_t l_pac = 0;
+    for(auto& e: v){
+        l_pac += e.length();
+    }
+    int64_t m_pac = addReverse ? l_pac * 2 : l_pac;
+    uint8_t* pac = (uint8_t*)std::calloc(m_pac/4 + 1, 1);
+    int64_t l = 0;
+    for(auto& e: v){
+        // ambiguous bases are replaced by random bases as addSeq2pac does
+        auto amb = e.mAmbs.begin();
+        for(size_t i = 0; i < e.length(); ++i, ++l){
+            while(amb != e.mAmbs.end() && amb->offset + amb->len <= i){
+                ++amb;
+            }
+            int c = (amb != e.mAmbs.end() && amb->offset <= i) ? (lrand48()&3) : e.code(i);
+            _set_pac(pac, l, c);
+        }
+    }
+    if(addReverse){
+        for(int64_t i = l_pac - 1; i >= 0; --i, ++l){
+            _set_pac(pac, l, 3-_get_pac(pac, i));
+        }
+    }
+    return pac;
+}
+
 void OnlineBWA::writePacToFile(const std::string& file) const{
     FILE* fp;
     std::string fname = file + ".pac";
@@ -225,27 +256,7 @@ void OnlineBWA::alignSeq(const std::string& seq, const std::string& name, std::v
         if(a.is_rev){
             fseq = util::reverseComplement(seq);
         }
-        for(uint32_t j = 0; j < fseq.length(); ++j){
-            uint8_t base = 15;
-            switch(fseq[j]){
-                case 'A':
-                    base = 1;
-                    break;
-                case 'C':
-                    base = 2;
-                    break;
-                case 'G':
-                    base = 4;
-                    break;
-                case 'T':
-                    base = 8;
-                    break;
-                default:
-                    base = 15;
-            }
-            mbases[j >> 1] &= ~(0xF << ((~j & 1) << 2));
-            mbases[j >> 1] |= base << ((~j & 1) << 2);
-        }
+        ntutil::encodeNt16(fseq.data(), fseq.length(), mbases);
         uint8_t* quals = bam_get_qual(b);
         quals[0] = 0xff;
         size_t arn = ar.n;
@@ -283,12 +294,39 @@ void OnlineBWA::alignSeq(const kseq_t* seq, std::vector<bam1_t*>& result){
 }
 
 void OnlineBWA::constructIndex(const std::vector<UnalignedSeq>& uv){
-    if(!uv.size()){
+    if(uv.empty()){
         return;
     }
+    std::vector<std::pair<std::string, size_t>> seqs;
     for(auto& e: uv){
-        if(e.mName.empty() || e.mSeq.empty()){
-            util::errorExit("nama and sequence must all be unempty to construct a index");
+        seqs.emplace_back(e.mName, e.mSeq.length());
+    }
+    // construct the forward-only pac
+    uint8_t* fwd_pac = makePac(uv, false);
+    // construct the forward-reverse pac
+    uint8_t* pac = makePac(uv, true);
+    constructIndex(fwd_pac, pac, seqs);
+}
+
+void OnlineBWA::constructIndex(const std::vector<PackedSeq>& pv){
+    if(pv.empty()){
+        return;
+    }
+    std::vector<std::pair<std::string, size_t>> seqs;
+    for(auto& e: pv){
+        seqs.emplace_back(e.mName, e.length());
+    }
+    // construct the forward-only pac
+    uint8_t* fwd_pac = makePac(pv, false);
+    // construct the forward-reverse pac
+    uint8_t* pac = makePac(pv, true);
+    constructIndex(fwd_pac, pac, seqs);
+}
+
+void OnlineBWA::constructIndex(uint8_t* fwdPac, uint8_t* pac, const std::vector<std::pair<std::string, size_t>>& seqs){
+    for(auto& e: seqs){
+        if(e.first.empty() || e.second == 0){
+            util::errorExit("name and sequence must all be unempty to construct a index");
         }
     }
     if(mIndex){
@@ -297,13 +335,9 @@ void OnlineBWA::constructIndex(const std::vector<UnalignedSeq>& uv){
     }
     // allocate memory for index
     mIndex = (bwaidx_t*)std::calloc(1, sizeof(bwaidx_t));
-    // construct the forward-only pac
-    uint8_t* fwd_pac = makePac(uv, false);
-    // construct the forward-reverse pac
-    uint8_t* pac = makePac(uv, true);
     size_t tlen = 0;
-    for(auto& e: uv){
-        tlen += e.mSeq.length();
+    for(auto& e: seqs){
+        tlen += e.second;
     }
     // make the bwt
     bwt_t* bwt = pac2bwt(pac, tlen * 2);
@@ -314,22 +348,22 @@ void OnlineBWA::constructIndex(const std::vector<UnalignedSeq>& uv){
     bwt_gen_cnt_table(bwt);
     bntseq_t* bns = (bntseq_t*)std::calloc(1, sizeof(bntseq_t));
     bns->l_pac = tlen;
-    bns->n_seqs = uv.size();
+    bns->n_seqs = seqs.size();
     bns->seed = 11;
     bns->n_holes = 0;
     // make the anns
-    bns->anns = (bntann1_t*)std::calloc(uv.size(), sizeof(bntann1_t));
+    bns->anns = (bntann1_t*)std::calloc(seqs.size(), sizeof(bntann1_t));
     size_t offset = 0;
-    for(size_t k = 0; k < uv.size(); ++k){
-        addAnns(uv[k].mName, uv[k].mSeq, &bns->anns[k], offset);
-        offset += uv[k].mSeq.length();
+    for(size_t k = 0; k < seqs.size(); ++k){
+        addAnns(seqs[k].first, seqs[k].second, &bns->anns[k], offset);
+        offset += seqs[k].second;
     }
     // ambs is 'holes', like N bases
     bns->ambs = 0;
     // make the in-memory idx struct
     mIndex->bwt = bwt;
     mIndex->bns = bns;
-    mIndex->pac = fwd_pac;
+    mIndex->pac = fwdPac;
     return;
 }
 
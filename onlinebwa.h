@@ -11,6 +11,7 @@
 #include <cassert>
 #include <zlib.h>
 #include "util.h"
+#include "ntutil.h"
 #include "bwa/bwa.h"
 #include "bwa/bwt.h"
 #include "bwa/kseq.h"
@@ -59,6 +60,14 @@ class OnlineBWA{
          */
         void addAnns(const std::string& name, const std::string& seq, bntann1_t* ann, size_t offset);
 
+        /** add an annotation sequence by length
+         * @param name reference of annotation name
+         * @param len length of annotation sequence
+         * @param ann pointer to bntann1_t struct
+         * @param offset offset of bntann1_t to add annotation
+         */
+        void addAnns(const std::string& name, size_t len, bntann1_t* ann, size_t offset);
+
         /** bwa mem add1 function */
         uint8_t* addSeq2pac(const kseq_t* seq, bntseq_t* bns, uint8_t* pac, int64_t *m_pac, int *m_seqs, int *m_holes, bntamb1_t **q);
 
@@ -68,6 +77,12 @@ class OnlineBWA{
          */
         uint8_t* makePac(std::vector<UnalignedSeq> v, bool addReverse);
 
+        /** make the pac structure for a bunch of 2 bits packed reads
+         * @param v vector of PackedSeq
+         * @param addReverse add reverse sequence to pac if true
+         */
+        uint8_t* makePac(const std::vector<PackedSeq>& v, bool addReverse);
+
         /** write pac part of the index to file
          * @param file filename to write pac to
          */
@@ -97,6 +112,11 @@ class OnlineBWA{
          */
         void constructIndex(const std::vector<UnalignedSeq>& uv);
 
+        /** construct index from a list of PackedSeq, which takes about a quarter memory of UnalignedSeq
+         * @param pv vector of PackedSeq
+         */
+        void constructIndex(const std::vector<PackedSeq>& pv);
+
         /** load external bwt index
          * @param file index file
          */
@@ -189,6 +209,14 @@ class OnlineBWA{
             mMemOpt->pen_unpaired *= matchScore;
             mMemOpt->a = matchScore;
         }
+
+    private:
+        /** construct index from pacs made of a list of sequences, pacs are taken over and freed
+         * @param fwdPac forward-only pac of sequences
+         * @param pac forward-reverse pac of sequences
+         * @param seqs name and length of each sequence
+         */
+        void constructIndex(uint8_t* fwdPac, uint8_t* pac, const std::vector<std::pair<std::string, size_t>>& seqs);
 };
 
 #endif
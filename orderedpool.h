@@ -0,0 +1,167 @@
+#ifndef ORDEREDPOOL_H
+#define ORDEREDPOOL_H
+
+#include <map>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <condition_variable>
+
+/** Class to process items submitted by one producer thread in a pool of worker threads\n
+ * each item is processed into a default constructed result in a worker, results are handed to a sink serially,\n
+ * either in submission order or in finishing order, at most maxInFlight items are submitted but not yet sunk,\n
+ * items are recycled after sunk and can be acquired by the producer to reuse their buffers
+ * @tparam T item type submitted by producer
+ * @tparam R result type of an item
+ */
+template<typename T, typename R>
+class OrderedPool{
+    bool mOrdered;                                   ///< hand results to sink in submission order if true
+    size_t mMaxInFlight;                             ///< maximum items submitted but not yet sunk
+    std::deque<std::pair<uint64_t, T>> mQueue;       ///< items waiting to be processed
+    std::map<uint64_t, std::pair<T, R>> mDone;       ///< items processed but not sunk yet in ordered mode
+    std::vector<T> mFree;                            ///< sunk items to be reused
+    std::function<void(T&, R&)> mSink;               ///< function called serially on each processed item
+    uint64_t mNextSubmit;                            ///< index of next item to be submitted
+    uint64_t mNextSink;                              ///< number of items sunk
+    bool mStop;                                      ///< worker threads should stop once all items sunk if true
+    std::vector<std::thread> mWorkers;               ///< worker threads
+    std::mutex mMtx;                                 ///< mutex to guard queue status
+    std::mutex mSinkMtx;                             ///< mutex to serialize sink calls
+    std::condition_variable mCond;                   ///< condition variable to notify queue status change
+
+    public:
+    /** Construct an OrderedPool
+     * @param ordered hand results to sink in submission order if true
+     */
+    OrderedPool(bool ordered = true){
+        mOrdered = ordered;
+        mMaxInFlight = 1;
+        mNextSubmit = 0;
+        mNextSink = 0;
+        mStop = false;
+    }
+
+    /** OrderedPool destructor, wait until all items submitted sunk */
+    ~OrderedPool(){
+        finish();
+    }
+
+    /** start worker threads
+     * @param threads number of worker threads
+     * @param maxInFlight maximum items submitted but not yet sunk, submit blocks once reached
+     * @param work function called in worker threads as work(T& item, R& result), copied into each worker so it can keep per thread state
+     * @param sink function called serially as sink(T& item, R& result) once for each item
+     */
+    template<typename W, typename S>
+    inline void start(int threads, size_t maxInFlight, W work, S sink){
+        mMaxInFlight = std::max((size_t)1, maxInFlight);
+        mSink = sink;
+        mStop = false;
+        for(int i = 0; i < std::max(1, threads); ++i){
+            mWorkers.push_back(std::thread([this, work]() mutable {workLoop(work);}));
+        }
+    }
+
+    /** take a sunk item to reuse its buffers
+     * @param item item to store the sunk item, untouched if none available
+     * @return true if a sunk item is taken
+     */
+    inline bool acquire(T& item){
+        std::lock_guard<std::mutex> l(mMtx);
+        if(mFree.empty()){
+            return false;
+        }
+        item = std::move(mFree.back());
+        mFree.pop_back();
+        return true;
+    }
+
+    /** submit an item to worker threads, wait if too many items not sunk yet
+     * @param item item to be processed
+     */
+    inline void submit(T&& item){
+        {
+            std::unique_lock<std::mutex> l(mMtx);
+            mCond.wait(l, [this]{return mNextSubmit < mNextSink + mMaxInFlight;});
+            mQueue.emplace_back(mNextSubmit++, std::move(item));
+        }
+        mCond.notify_all();
+    }
+
+    /** get number of items submitted
+     * @return number of items submitted
+     */
+    inline uint64_t submitted(){
+        std::lock_guard<std::mutex> l(mMtx);
+        return mNextSubmit;
+    }
+
+    /** wait until all items submitted sunk */
+    inline void wait(){
+        std::unique_lock<std::mutex> l(mMtx);
+        mCond.wait(l, [this]{return mNextSink == mNextSubmit;});
+    }
+
+    /** wait until all items submitted sunk and stop worker threads */
+    inline void finish(){
+        {
+            std::lock_guard<std::mutex> l(mMtx);
+            mStop = true;
+        }
+        mCond.notify_all();
+        for(auto& t: mWorkers){
+            t.join();
+        }
+        mWorkers.clear();
+    }
+
+    private:
+    /** worker thread routine, process items until stopped and all items sunk
+     * @param work function called for each item
+     */
+    template<typename W>
+    inline void workLoop(W& work){
+        while(true){
+            std::pair<uint64_t, T> item;
+            {
+                std::unique_lock<std::mutex> l(mMtx);
+                mCond.wait(l, [this]{return mStop || !mQueue.empty();});
+                if(mQueue.empty()){
+                    break;
+                }
+                item = std::move(mQueue.front());
+                mQueue.pop_front();
+            }
+            R result{};
+            work(item.second, result);
+            uint64_t finished = 0;
+            {
+                std::lock_guard<std::mutex> s(mSinkMtx);
+                if(mOrdered){
+                    mDone.emplace(item.first, std::make_pair(std::move(item.second), std::move(result)));
+                    for(auto iter = mDone.begin(); iter != mDone.end() && iter->first == mNextSink + finished; iter = mDone.erase(iter)){
+                        mSink(iter->second.first, iter->second.second);
+                        std::lock_guard<std::mutex> l(mMtx);
+                        mFree.push_back(std::move(iter->second.first));
+                        ++finished;
+                    }
+                }else{
+                    mSink(item.second, result);
+                    std::lock_guard<std::mutex> l(mMtx);
+                    mFree.push_back(std::move(item.second));
+                    finished = 1;
+                }
+                std::lock_guard<std::mutex> l(mMtx);
+                mNextSink += finished;
+            }
+            mCond.notify_all();
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,262 @@
+#ifndef PAIREDREADER_H
+#define PAIREDREADER_H
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+#include <condition_variable>
+#include <zlib.h>
+#include "kseq.h"
+
+/** Structure to hold a batch of read pairs returned by PairedReader */
+struct SeqPairBatch{
+    const krec_t* r1 = NULL;   ///< read1 records
+    const krec_t* r2 = NULL;   ///< read2 records, r2[i] is the mate of r1[i]
+    int n = 0;                 ///< number of read pairs
+    std::vector<int> mismatch; ///< indexes of read pairs whose names do not match
+};
+
+/** Class to read paired-end fasta/fastq files in batches\n
+ * read1 and read2 are inflated and parsed concurrently in two threads, at most 4 batches ahead of consumer,\n
+ * read names of each pair are checked as batches are handed out
+ */
+class PairedReader{
+    /** Structure to hold reading status of one end */
+    struct EndReader{
+        std::string filename;                        ///< input filename
+        gzFile fp = NULL;                            ///< gzFile handler of input
+        kseq_t* seq = NULL;                          ///< kseq stream of input
+        std::deque<std::pair<krec_t*, int>> queue;   ///< batches read but not handed out
+        std::vector<krec_t*> freeRecs;               ///< record arrays to be reused
+        bool end = false;                            ///< all batches have been read
+        int ret = 0;                                 ///< return value of last kseq_read
+        std::thread thread;                          ///< reading thread
+    };
+
+    EndReader mEnds[2];                  ///< read1 and read2 reader
+    int mBatchSize;                      ///< number of read pairs in a batch
+    bool mCheckName;                     ///< check read names of pairs if true
+    size_t mMaxBatches;                  ///< maximum batches read ahead in each end
+    krec_t* mCur[2];                     ///< record arrays of batch handed out last time
+    uint64_t mPairs;                     ///< number of read pairs handed out
+    uint64_t mMismatches;                ///< number of read pairs whose names do not match
+    bool mStop;                          ///< reading threads should stop if true
+    bool mError;                         ///< error occurs if true
+    std::string mPendingError;           ///< error found in last batch, reported on next read after pairs before it handed out
+    std::mutex mMtx;                     ///< mutex to guard batch queues
+    std::condition_variable mCond;       ///< condition variable to notify batch queue status change
+
+    public:
+    /** Construct a PairedReader and start reading threads
+     * @param r1 read1 fasta/fastq file, plain or gz
+     * @param r2 read2 fasta/fastq file, plain or gz
+     * @param batchSize number of read pairs in a batch
+     * @param checkName check read names of pairs if true
+     */
+    PairedReader(const std::string& r1, const std::string& r2, int batchSize = 4096, bool checkName = true){
+        mBatchSize = std::max(1, batchSize);
+        mCheckName = checkName;
+        mMaxBatches = 4;
+        mCur[0] = mCur[1] = NULL;
+        mPairs = 0;
+        mMismatches = 0;
+        mStop = false;
+        mError = false;
+        mEnds[0].filename = r1;
+        mEnds[1].filename = r2;
+        for(int i = 0; i < 2; ++i){
+            mEnds[i].fp = gzopen(mEnds[i].filename.c_str(), "r");
+            if(mEnds[i].fp == NULL){
+                std::cerr << "Failed to open file: " << mEnds[i].filename << std::endl;
+                std::exit(1);
+            }
+            gzbuffer(mEnds[i].fp, 1 << 20);
+            mEnds[i].seq = kseq_init(mEnds[i].fp);
+        }
+        for(int i = 0; i < 2; ++i){
+            mEnds[i].thread = std::thread(&PairedReader::readLoop, this, i);
+        }
+    }
+
+    /** PairedReader destructor, stop reading threads and free records */
+    ~PairedReader(){
+        {
+            std::lock_guard<std::mutex> l(mMtx);
+            mStop = true;
+        }
+        mCond.notify_all();
+        for(int i = 0; i < 2; ++i){
+            mEnds[i].thread.join();
+            for(auto& b: mEnds[i].queue){
+                krecs_destroy(b.first, mBatchSize);
+            }
+            for(auto& r: mEnds[i].freeRecs){
+                krecs_destroy(r, mBatchSize);
+            }
+            krecs_destroy(mCur[i], mBatchSize);
+            kseq_destroy(mEnds[i].seq);
+            gzclose(mEnds[i].fp);
+        }
+    }
+
+    /** get next batch of read pairs, records of last batch are invalid after this call\n
+     * if read numbers of two ends differ or an end fails in a batch, complete pairs before it are handed out first,\n
+     * and the error is reported by next call
+     * @param batch SeqPairBatch to store read pairs
+     * @return false if no more read pairs or any error occurs
+     */
+    inline bool read(SeqPairBatch& batch){
+        batch.r1 = batch.r2 = NULL;
+        batch.n = 0;
+        batch.mismatch.clear();
+        std::pair<krec_t*, int> got[2];
+        int failed = -1;
+        {
+            std::unique_lock<std::mutex> l(mMtx);
+            for(int i = 0; i < 2; ++i){
+                if(mCur[i]){
+                    mEnds[i].freeRecs.push_back(mCur[i]);
+                    mCur[i] = NULL;
+                }
+            }
+            mCond.notify_all();
+            if(mError){
+                return false;
+            }
+            if(!mPendingError.empty()){
+                std::cerr << mPendingError << std::endl;
+                mError = true;
+                return false;
+            }
+            mCond.wait(l, [this]{
+                return (!mEnds[0].queue.empty() || mEnds[0].end) && (!mEnds[1].queue.empty() || mEnds[1].end);
+            });
+            for(int i = 0; i < 2; ++i){
+                if(mEnds[i].queue.empty()){
+                    got[i] = std::make_pair((krec_t*)NULL, 0);
+                }else{
+                    got[i] = mEnds[i].queue.front();
+                    mEnds[i].queue.pop_front();
+                }
+                mCur[i] = got[i].first;
+                if(failed < 0 && mEnds[i].end && mEnds[i].ret < -1 && mEnds[i].queue.empty()){
+                    failed = i;
+                }
+            }
+        }
+        mCond.notify_all();
+        int n = std::min(got[0].second, got[1].second);
+        if(got[0].second != got[1].second || n == 0){
+            if(failed >= 0){
+                mPendingError = "Failed to read file: " + mEnds[failed].filename + (mEnds[failed].ret == -2 ? ", truncated quality string" : "");
+            }else if(got[0].second != got[1].second){
+                mPendingError = "Read number of " + mEnds[0].filename + " and " + mEnds[1].filename + " differs after " + std::to_string(mPairs + n) + " pairs";
+            }
+            if(n == 0){
+                if(!mPendingError.empty()){
+                    std::cerr << mPendingError << std::endl;
+                    mError = true;
+                }
+                return false;
+            }
+        }
+        batch.r1 = got[0].first;
+        batch.r2 = got[1].first;
+        batch.n = n;
+        if(mCheckName){
+            for(int i = 0; i < batch.n; ++i){
+                if(!isPairedName(batch.r1[i].name, batch.r2[i].name)){
+                    batch.mismatch.push_back(i);
+                }
+            }
+            mMismatches += batch.mismatch.size();
+        }
+        mPairs += batch.n;
+        return true;
+    }
+
+    /** whether all read pairs read successfully or not
+     * @return false if any error occurs
+     */
+    inline bool good(){
+        return !mError;
+    }
+
+    /** get number of read pairs handed out
+     * @return number of read pairs
+     */
+    inline uint64_t getPairs(){
+        return mPairs;
+    }
+
+    /** get number of read pairs whose names do not match
+     * @return number of mismatched read pairs
+     */
+    inline uint64_t getMismatches(){
+        return mMismatches;
+    }
+
+    /** test whether two read names are from the same pair, trailing /1 and /2 are ignored
+     * @param n1 read1 name
+     * @param n2 read2 name
+     * @return true if names are from the same pair
+     */
+    inline static bool isPairedName(const kstring_t& n1, const kstring_t& n2){
+        size_t l1 = n1.l, l2 = n2.l;
+        if(l1 == l2 && l1 > 2 && n1.s[l1 - 2] == '/' && n2.s[l2 - 2] == '/' && n1.s[l1 - 1] == '1' && n2.s[l2 - 1] == '2'){
+            l1 -= 2;
+            l2 -= 2;
+        }
+        return l1 == l2 && std::memcmp(n1.s, n2.s, l1) == 0;
+    }
+
+    private:
+    /** reading thread routine, read batches of one end until end of file or stopped
+     * @param e index of end, 0 for read1, 1 for read2
+     */
+    inline void readLoop(int e){
+        EndReader& end = mEnds[e];
+        while(true){
+            krec_t* recs = NULL;
+            {
+                std::unique_lock<std::mutex> l(mMtx);
+                mCond.wait(l, [&]{return mStop || end.queue.size() < mMaxBatches;});
+                if(mStop){
+                    break;
+                }
+                if(!end.freeRecs.empty()){
+                    recs = end.freeRecs.back();
+                    end.freeRecs.pop_back();
+                }
+            }
+            if(recs == NULL){
+                recs = krecs_init(mBatchSize);
+            }
+            int ret = 0;
+            int n = std::max(0, kseq_read_batch(end.seq, recs, mBatchSize, 0, &ret));
+            {
+                std::lock_guard<std::mutex> l(mMtx);
+                if(n > 0){
+                    end.queue.emplace_back(recs, n);
+                }else{
+                    end.freeRecs.push_back(recs);
+                }
+                if(n < mBatchSize){
+                    end.end = true;
+                    end.ret = ret;
+                }
+            }
+            mCond.notify_all();
+            if(n < mBatchSize){
+                break;
+            }
+        }
+    }
+};
+
+#endif
@@ -1,35 +1,264 @@
 #include <zlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
 #include <kseq.h>
 #include <util.h>
+#include "json.hpp"
+#include "filereader.h"
+#include "pairedreader.h"
 
-KSEQ_INIT(gzFile, gzread)
+/** Structure to hold result of one benchmark */
+struct BenchResult{
+    std::string mode;     ///< parsing mode, single, batch or paired
+    std::string files;    ///< input files
+    std::string format;   ///< input format, plain, gzip or bgzf
+    bool cold = false;    ///< page cache of input dropped before each run if true
+    uint64_t records = 0; ///< records parsed in each run, read pairs in paired mode
+    uint64_t bytes = 0;   ///< uncompressed Bytes parsed in each run
+    uint64_t fileBytes = 0; ///< Bytes of input files
+    std::vector<double> seconds; ///< seconds used by each run
+};
+
+/** get format of a fasta/fastq file
+ * @param fn fasta/fastq file
+ * @return plain, gzip or bgzf
+ */
+std::string getFormat(const std::string& fn){
+    if(FileReader::isBgzfFile(fn)){
+        return "bgzf";
+    }
+    unsigned char h[2] = {0, 0};
+    FILE* fp = fopen(fn.c_str(), "rb");
+    if(fp){
+        size_t len = fread(h, 1, 2, fp);
+        fclose(fp);
+        if(len == 2 && h[0] == 0x1f && h[1] == 0x8b){
+            return "gzip";
+        }
+    }
+    return "plain";
+}
+
+/** read a file through to get its uncompressed size, which also warms page cache
+ * @param fn input file
+ * @param fileBytes store Bytes of file
+ * @return uncompressed Bytes of file
+ */
+uint64_t getInflatedSize(const std::string& fn, uint64_t& fileBytes){
+    gzFile fp = gzopen(fn.c_str(), "r");
+    if(fp == NULL){
+        std::cerr << "Failed to open file: " << fn << std::endl;
+        std::exit(1);
+    }
+    gzbuffer(fp, 1 << 20);
+    std::vector<char> buf(1 << 20);
+    uint64_t size = 0;
+    int len = 0;
+    while((len = gzread(fp, buf.data(), buf.size())) > 0){
+        size += len;
+    }
+    fileBytes = gzoffset(fp);
+    gzclose(fp);
+    return size;
+}
+
+/** drop page cache of a file, only clean pages can be dropped
+ * @param fn input file
+ */
+void dropCache(const std::string& fn){
+    int fd = open(fn.c_str(), O_RDONLY);
+    if(fd >= 0){
+        fdatasync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+}
+
+/** parse all records of a file with kseq_read or kseq_read_batch
+ * @param fn fasta/fastq file
+ * @param batch number of records read in each kseq_read_batch call, 0 to use kseq_read
+ * @return number of records
+ */
+uint64_t parseSingle(const std::string& fn, int batch){
+    gzFile fp = gzopen(fn.c_str(), "r");
+    gzbuffer(fp, 1 << 20);
+    kseq_t *seq = kseq_init(fp);
+    uint64_t records = 0;
+    if(batch){
+        krec_t *recs = krecs_init(batch);
+        int n = 0;
+        while((n = kseq_read_batch(seq, recs, batch, 0, NULL)) > 0){
+            records += n;
+        }
+        krecs_destroy(recs, batch);
+    }else{
+        krec_t *rec = krec_init();
+        while(kseq_read(seq, rec) >= 0){
+            ++records;
+        }
+        krec_destroy(rec);
+    }
+    kseq_destroy(seq);
+    gzclose(fp);
+    return records;
+}
+
+/** parse all read pairs of two files with PairedReader
+ * @param r1 read1 file
+ * @param r2 read2 file
+ * @return number of read pairs
+ */
+uint64_t parsePaired(const std::string& r1, const std::string& r2){
+    PairedReader reader(r1, r2);
+    SeqPairBatch batch;
+    while(reader.read(batch));
+    return reader.getPairs();
+}
+
+/** run a benchmark
+ * @param mode parsing mode, single, batch or paired
+ * @param files input files, paired mode uses the first two
+ * @param repeat number of runs
+ * @param cold drop page cache of input before each run if true
+ * @return benchmark result
+ */
+BenchResult bench(const std::string& mode, const std::vector<std::string>& files, int repeat, bool cold){
+    BenchResult r;
+    r.mode = mode;
+    r.cold = cold;
+    r.format = getFormat(files[0]);
+    for(auto& f: files){
+        r.files.append(r.files.empty() ? "" : ",").append(f);
+        uint64_t fileBytes = 0;
+        r.bytes += getInflatedSize(f, fileBytes);
+        r.fileBytes += fileBytes;
+    }
+    for(int i = 0; i < repeat; ++i){
+        if(cold){
+            for(auto& f: files){
+                dropCache(f);
+            }
+        }
+        auto beg = std::chrono::steady_clock::now();
+        if(mode == "paired"){
+            r.records = parsePaired(files[0], files[1]);
+        }else{
+            r.records = parseSingle(files[0], mode == "batch" ? 4096 : 0);
+        }
+        r.seconds.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - beg).count());
+    }
+    return r;
+}
+
+/** get median seconds of all runs of a benchmark
+ * @param r benchmark result
+ * @return median seconds
+ */
+double medianSeconds(const BenchResult& r){
+    std::vector<double> secs = r.seconds;
+    std::sort(secs.begin(), secs.end());
+    return secs[secs.size() / 2];
+}
+
+/** output benchmark results in json format
+ * @param os ostream to output to
+ * @param results benchmark results
+ */
+void writeJson(std::ostream& os, const std::vector<BenchResult>& results){
+    jsn::json j;
+    j["time"] = util::currentTime();
+    j["results"] = jsn::json::array();
+    for(auto& r: results){
+        double median = medianSeconds(r);
+        jsn::json jr;
+        jr["mode"] = r.mode;
+        jr["files"] = r.files;
+        jr["format"] = r.format;
+        jr["cache"] = r.cold ? "cold" : "warm";
+        jr["records"] = r.records;
+        jr["bytes"] = r.bytes;
+        jr["file_bytes"] = r.fileBytes;
+        jr["runs"] = r.seconds;
+        jr["best_seconds"] = *std::min_element(r.seconds.begin(), r.seconds.end());
+        jr["median_seconds"] = median;
+        jr["records_per_second"] = r.records / median;
+        jr["mb_per_second"] = r.bytes / 1048576.0 / median;
+        j["results"].push_back(jr);
+    }
+    os << j.dump(4) << std::endl;
+}
 
 int main(int argc, char *argv[])
 {
-	gzFile fp1;
-    gzFile fp2;
-	kseq_t *seq1;
-    kseq_t *seq2;
-	int l, m;
-	if (argc < 3) {
-		fprintf(stderr, "Usage: %s <fqr1> <fqr2> <readname>\n", argv[0]);
-		return 1;
-	}
-	fp1 = gzopen(argv[1], "r");
-    fp2 = gzopen(argv[2], "r");
-	seq1 = kseq_init(fp1);
-    seq2 = kseq_init(fp2);
-    std::cout << "r1beg: " << util::currentTime() << std::endl;
-    while((l = kseq_read(seq1)) >= 0);
-    std::cout << "r1end: " << util::currentTime() << std::endl;
-    std::cout << "r2beg: " << util::currentTime() << std::endl;
-    while((m = kseq_read(seq2)) >= 0);
-    std::cout << "r2end: " << util::currentTime() << std::endl;
-	kseq_destroy(seq1);
-    kseq_destroy(seq2);
-	gzclose(fp1);
-    gzclose(fp2);
+    std::vector<std::string> files;
+    std::string modes = "single,batch,paired";
+    std::string out;
+    int repeat = 3;
+    std::string caches = "warm";
+    for(int i = 1; i < argc; ++i){
+        std::string arg = argv[i];
+        if(arg == "-m" && i + 1 < argc){
+            modes = argv[++i];
+        }else if(arg == "-r" && i + 1 < argc){
+            repeat = std::max(1, std::atoi(argv[++i]));
+        }else if(arg == "-o" && i + 1 < argc){
+            out = argv[++i];
+        }else if(arg == "-k" && i + 1 < argc){
+            caches = argv[++i];
+        }else{
+            files.push_back(arg);
+        }
+    }
+    if (files.empty()) {
+        fprintf(stderr, "Usage: %s [options] <fq1> [fq2]\n", argv[0]);
+        fprintf(stderr, "  -m modes    parsing modes separated by comma, single/batch/paired [%s]\n", modes.c_str());
+        fprintf(stderr, "  -r repeat   number of runs of each mode [%d]\n", repeat);
+        fprintf(stderr, "  -k caches   page cache states separated by comma, warm/cold, cold drops page cache of input before each run [%s]\n", caches.c_str());
+        fprintf(stderr, "  -o file     output json result to file, stdout by default\n");
+        return 1;
+    }
+    std::vector<std::string> vmodes;
+    std::vector<std::string> vcaches;
+    util::split(modes, vmodes, ",");
+    util::split(caches, vcaches, ",");
+    std::vector<BenchResult> results;
+    for(auto& c: vcaches){
+        if(c != "warm" && c != "cold"){
+            std::cerr << "unknown cache state: " << c << ", skipped" << std::endl;
+            continue;
+        }
+        for(auto& m: vmodes){
+            if(m == "paired"){
+                if(files.size() < 2){
+                    std::cerr << "paired mode needs two files, skipped" << std::endl;
+                    continue;
+                }
+                results.push_back(bench(m, {files[0], files[1]}, repeat, c == "cold"));
+            }else if(m == "single" || m == "batch"){
+                for(auto& f: files){
+                    results.push_back(bench(m, {f}, repeat, c == "cold"));
+                }
+            }else{
+                std::cerr << "unknown mode: " << m << ", skipped" << std::endl;
+            }
+        }
+    }
+    for(auto& r: results){
+        std::cerr << r.mode << "\t" << (r.cold ? "cold" : "warm") << "\t" << r.files << "\t" << r.format << "\t" << r.records << " records\t";
+        std::cerr << r.records / medianSeconds(r) << " records/s\t" << r.bytes / 1048576.0 / medianSeconds(r) << " MB/s" << std::endl;
+    }
+    if(out.empty()){
+        writeJson(std::cout, results);
+    }else{
+        std::ofstream ofs(out);
+        writeJson(ofs, results);
+    }
 	return 0;
 }
@@ -2,21 +2,12 @@
 #include "filereader.h"
 #include "filewriter.h"
 #include "util.h"
+#include "ntutil.h"
 #include <iostream>
 #include <cassert>
 #include <sstream>
 #include <map>
 
-double gcContent(char* seq, int len){
-    int gc = 0;
-    for(int i = 0; i < len; ++i){
-        if(seq[i] == 'G' || seq[i] == 'C' || seq[i] == 'g' || seq[i] == 'c'){
-            ++gc;
-        }
-    }
-    return double(gc)/double(len);
-}
-
 double avgDepth(std::vector<int>& depv, int beg, int end){
     int totDept = 0;
     for(int i = beg; i < end; ++i){
@@ -27,15 +18,17 @@ double avgDepth(std::vector<int>& depv, int beg, int end){
 
 void depMap(const char* file, std::map<std::string, std::vector<int>>& dmap){
     FileReader dr(file);
-    std::string tstr;
-    std::vector<std::string> vstr;
+    std::string_view tstr;
+    std::vector<std::string_view> vstr;
+    std::string name;
+    std::vector<int>* dep = NULL;
     while(dr.getline(tstr)){
-        util::split(tstr, vstr, "\t");
-        if(dmap.find(vstr[0]) == dmap.end()){
-            dmap[vstr[0]] = {std::atoi(vstr[2].c_str())};
-        }else{
-            dmap[vstr[0]].push_back(std::atoi(vstr[2].c_str()));
+        util::splitView(tstr, vstr, '\t', 4);
+        if(dep == NULL || vstr[0] != name){
+            name.assign(vstr[0]);
+            dep = &dmap[name];
         }
+        dep->push_back(util::str2num<int>(vstr[2]));
     }
 }
 
@@ -51,37 +44,46 @@ int main(int argc, char** argv){
     char* infa = argv[1];
     char* inreg = argv[2];
     int step = std::atoi(argv[3]);
+    if(step <= 0){
+        std::cerr << "step must be a positive integer" << std::endl;
+        std::exit(1);
+    }
 
     faidx_t* fai = fai_load(infa);
     FileReader fr(inreg);
-    std::string line;
-    std::vector<std::string> vs;
+    std::string_view line;
+    std::vector<std::string_view> vs;
     int len;
     std::stringstream result;
     while(fr.getline(line)){
-        util::split(line, vs, "\t");
-        std::string name = vs[0];
-        int beg = std::atoi(vs[1].c_str());
-        int end = std::atoi(vs[2].c_str());
+        util::splitView(line, vs, '\t', 4);
+        std::string name(vs[0]);
+        int beg = util::str2num<int>(vs[1]);
+        int end = util::str2num<int>(vs[2]);
         char* s = faidx_fetch_seq(fai, name.c_str(), beg, end, &len);
+        if(s == NULL || len <= 0){
+            std::cerr << "Failed to fetch sequence of region " << name << ":" << beg << "-" << end << ", skipped" << std::endl;
+            free(s);
+            continue;
+        }
         int count = 0;
         std::vector<double> gcv;
         std::vector<int> posv;
         std::vector<double> aidp;
         std::vector<double> addp;
+        ntutil::windowGC(s, len, step, step, gcv);
         while(count + step <= len){
-            gcv.push_back(gcContent(s + count, step));
             addp.push_back(avgDepth(ddp[name], count, count + step));
             aidp.push_back(avgDepth(idp[name], count, count + step));
             count += step;
             posv.push_back(count);
         }
         if(count < len){
-            gcv.push_back(gcContent(s + count, len - count));
             addp.push_back(avgDepth(ddp[name], count, ddp[name].size()));
             aidp.push_back(avgDepth(idp[name], count, idp[name].size()));
             posv.push_back(len);
         }
+        free(s);
         result << name;
         for(size_t i = 0; i < posv.size(); ++i){
             result << "\t" << posv[i];
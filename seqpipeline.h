@@ -0,0 +1,101 @@
+#ifndef SEQPIPELINE_H
+#define SEQPIPELINE_H
+
+#include <string>
+#include <iostream>
+#include <algorithm>
+#include <zlib.h>
+#include "kseq.h"
+#include "orderedpool.h"
+
+/** Class to process fasta/fastq records of a file in a three stage pipeline\n
+ * the calling thread inflates and parses records into batches, a pool of worker threads process the batches,\n
+ * results of each batch are handed to a sink serially in input order, where they can be written to a FileWriter\n
+ * which compresses and writes them in background, at most threads * 4 batches are in flight at any time
+ */
+class SeqPipeline{
+    /** Structure to hold a batch of records */
+    struct SeqBatch{
+        krec_t* recs = NULL;  ///< records of this batch
+        int n = 0;            ///< number of records in this batch
+    };
+
+    std::string mFilename;               ///< input fasta/fastq filename
+    gzFile mFp;                          ///< gzFile handler of input
+    kseq_t* mSeq;                        ///< kseq stream of input
+    int mThreads;                        ///< number of worker threads
+    int mBatchSize;                      ///< maximum records in a batch
+    size_t mBatchBytes;                  ///< maximum Bytes of records in a batch
+    size_t mMaxBatches;                  ///< maximum batches read but not yet handed to sink
+
+    public:
+    /** Construct a SeqPipeline
+     * @param filename input fasta/fastq file, plain or gz
+     * @param threads number of worker threads
+     * @param batchSize maximum records in a batch
+     * @param batchBytes maximum Bytes of records in a batch
+     */
+    SeqPipeline(const std::string& filename, int threads, int batchSize = 4096, size_t batchBytes = (1 << 22)){
+        mFilename = filename;
+        mFp = gzopen(filename.c_str(), "r");
+        if(mFp == NULL){
+            std::cerr << "Failed to open file: " << filename << std::endl;
+            std::exit(1);
+        }
+        gzbuffer(mFp, 1 << 20);
+        mSeq = kseq_init(mFp);
+        mThreads = std::max(1, threads);
+        mBatchSize = std::max(1, batchSize);
+        mBatchBytes = batchBytes;
+        mMaxBatches = mThreads * 4;
+    }
+
+    /** SeqPipeline destructor */
+    ~SeqPipeline(){
+        kseq_destroy(mSeq);
+        gzclose(mFp);
+    }
+
+    /** process all records left in input, the calling thread reads batches while worker threads process them
+     * @param work function called in worker threads as work(const krec_t* recs, int n, R& result) for each batch
+     * @param sink function called serially in input order as sink(R& result) once for each batch
+     * @tparam R result type of a batch, a default constructed R is used for each batch
+     * @return false if input is truncated or failed to read
+     */
+    template<typename R, typename W, typename S>
+    inline bool run(W work, S sink){
+        OrderedPool<SeqBatch, R> pool;
+        pool.start(mThreads, mMaxBatches, [&](SeqBatch& batch, R& result){
+            work((const krec_t*)batch.recs, batch.n, result);
+        }, [&](SeqBatch&, R& result){
+            sink(result);
+        });
+        int ret = 0;
+        SeqBatch batch;
+        while(true){
+            if(!pool.acquire(batch)){
+                batch.recs = krecs_init(mBatchSize);
+            }
+            batch.n = std::max(0, kseq_read_batch(mSeq, batch.recs, mBatchSize, mBatchBytes, &ret));
+            if(batch.n == 0){
+                krecs_destroy(batch.recs, mBatchSize);
+                break;
+            }
+            pool.submit(std::move(batch));
+            if(ret < -1){
+                break;
+            }
+        }
+        pool.finish();
+        while(pool.acquire(batch)){
+            krecs_destroy(batch.recs, mBatchSize);
+        }
+        if(ret < -1){
+            std::cerr << "Failed to read file: " << mFilename << (ret == -2 ? ", truncated quality string" : "") << std::endl;
+            return false;
+        }
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,162 @@
+#ifndef SEQWRITER_H
+#define SEQWRITER_H
+
+#include <string>
+#include <algorithm>
+#include <string_view>
+#include "filewriter.h"
+
+/** Class to write FASTA/FASTQ records to plain/gz/bgzf file\n
+ * records are assembled in the large output buffer of FileWriter, so compression and IO work on big blocks
+ */
+class SeqWriter{
+    FileWriter* mWriter; ///< pointer to FileWriter to write records to
+    bool mOwnWriter;     ///< mWriter is created by SeqWriter and should be deleted if true
+
+    public:
+    /** Construct a SeqWriter to write records to file
+     * @param filename output filename, ends with .gz to write gz file
+     * @param compression compression level for gz file
+     * @param threads number of threads to compress gz output, see FileWriter
+     */
+    SeqWriter(const std::string& filename, int compression = 3, int threads = 1){
+        mWriter = new FileWriter(filename, compression, threads);
+        mOwnWriter = true;
+    }
+
+    /** Construct a SeqWriter to write records to an existing FileWriter
+     * @param writer pointer to FileWriter
+     */
+    SeqWriter(FileWriter* writer){
+        mWriter = writer;
+        mOwnWriter = false;
+    }
+
+    /** SeqWriter destructor */
+    ~SeqWriter(){
+        if(mOwnWriter){
+            delete mWriter;
+            mWriter = NULL;
+        }
+    }
+
+    /** get the FileWriter records written to
+     * @return pointer to FileWriter
+     */
+    inline FileWriter* getWriter(){
+        return mWriter;
+    }
+
+    /** write a FASTA record
+     * @param name read name
+     * @param seq read sequence
+     * @param comment read comment, appended to name with a space if not empty
+     * @param lineWidth wrap sequence into lines of lineWidth bases, 0 for no wrapping
+     * @return true if successfully written
+     */
+    inline bool writeFasta(std::string_view name, std::string_view seq, std::string_view comment = std::string_view(), size_t lineWidth = 0){
+        bool status = mWriter->appendChar('>');
+        status &= writeHeader(name, comment);
+        if(lineWidth == 0 || seq.size() <= lineWidth){
+            status &= mWriter->append(seq);
+            return mWriter->appendChar('\n') && status;
+        }
+        for(size_t i = 0; i < seq.size(); i += lineWidth){
+            status &= mWriter->append(seq.substr(i, lineWidth));
+            status &= mWriter->appendChar('\n');
+        }
+        return status;
+    }
+
+    /** write a FASTQ record
+     * @param name read name
+     * @param seq read sequence
+     * @param qual read quality
+     * @param comment read comment, appended to name with a space if not empty
+     * @return true if successfully written
+     */
+    inline bool writeFastq(std::string_view name, std::string_view seq, std::string_view qual, std::string_view comment = std::string_view()){
+        bool status = mWriter->appendChar('@');
+        status &= writeHeader(name, comment);
+        status &= mWriter->append(seq);
+        status &= mWriter->append("\n+\n", 3);
+        status &= mWriter->append(qual);
+        return mWriter->appendChar('\n') && status;
+    }
+
+    /** format a FASTA record and append it to a string, for records formatted in worker threads
+     * @param out string to append record to
+     * @param name read name
+     * @param seq read sequence
+     * @param comment read comment, appended to name with a space if not empty
+     * @param lineWidth wrap sequence into lines of lineWidth bases, 0 for no wrapping
+     */
+    inline static void formatFasta(std::string& out, std::string_view name, std::string_view seq, std::string_view comment = std::string_view(), size_t lineWidth = 0){
+        out.push_back('>');
+        formatHeader(out, name, comment);
+        if(lineWidth == 0){
+            lineWidth = std::max((size_t)1, seq.size());
+        }
+        for(size_t i = 0; i < seq.size(); i += lineWidth){
+            out.append(seq.substr(i, lineWidth));
+            out.push_back('\n');
+        }
+        if(seq.empty()){
+            out.push_back('\n');
+        }
+    }
+
+    /** format a FASTQ record and append it to a string, for records formatted in worker threads
+     * @param out string to append record to
+     * @param name read name
+     * @param seq read sequence
+     * @param qual read quality
+     * @param comment read comment, appended to name with a space if not empty
+     */
+    inline static void formatFastq(std::string& out, std::string_view name, std::string_view seq, std::string_view qual, std::string_view comment = std::string_view()){
+        out.push_back('@');
+        formatHeader(out, name, comment);
+        out.append(seq);
+        out.append("\n+\n", 3);
+        out.append(qual);
+        out.push_back('\n');
+    }
+
+    /** flush records written to file
+     * @return true if all records written successfully
+     */
+    inline bool flush(){
+        return mWriter->flush();
+    }
+
+    private:
+    /** format name and comment of a record, leading '>' or '@' excluded
+     * @param out string to append to
+     * @param name read name
+     * @param comment read comment
+     */
+    inline static void formatHeader(std::string& out, std::string_view name, std::string_view comment){
+        out.append(name);
+        if(!comment.empty()){
+            out.push_back(' ');
+            out.append(comment);
+        }
+        out.push_back('\n');
+    }
+
+    /** write name and comment of a record, leading '>' or '@' excluded
+     * @param name read name
+     * @param comment read comment
+     * @return true if successfully written
+     */
+    inline bool writeHeader(std::string_view name, std::string_view comment){
+        bool status = mWriter->append(name);
+        if(!comment.empty()){
+            status &= mWriter->appendChar(' ');
+            status &= mWriter->append(comment);
+        }
+        return mWriter->appendChar('\n') && status;
+    }
+};
+
+#endif
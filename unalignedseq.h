@@ -1,9 +1,13 @@
 #ifndef UNALIGNED_SEQ_H
 #define UNALIGNED_SEQ_H
 
+#include <cctype>
 #include <cstring>
+#include <cstdint>
+#include <string>
 #include <vector>
 #include <iostream>
+#include "ntutil.h"
 
 /** Structure to hold unaligned sequence (name and bases) */
 class UnalignedSeq{
@@ -52,4 +56,175 @@ class UnalignedSeq{
         }
 };
 
+/** Structure to hold a run of identical non-ACGT bases in a PackedSeq */
+struct PackedAmb{
+    uint32_t offset; ///< offset of the first base of this run
+    uint32_t len;    ///< length of this run
+    char base;       ///< base of this run, like N
+};
+
+/** Class to hold unaligned sequence with bases packed in 2 bits\n
+ * non-ACGT bases are kept in a sparse table of runs, like ambiguity holes in bwa index,\n
+ * quality scores are optional and can be binned to 4 bits each
+ */
+class PackedSeq{
+    public:
+        /** quality score storage mode */
+        enum QualMode{
+            QUAL_NONE = 0, ///< drop quality scores
+            QUAL_FULL = 1, ///< keep quality scores as they are, 1 Byte each
+            QUAL_BIN = 2   ///< keep quality scores binned to 8 levels, 4 bits each
+        };
+
+        std::string mName;              ///< name of the contig
+        std::string mComment;           ///< comment of the contig
+        std::vector<uint8_t> mPac;      ///< bases packed in 2 bits, A/C/G/T as 0/1/2/3, first base in highest bits
+        std::vector<PackedAmb> mAmbs;   ///< runs of non-ACGT bases, stored as A in mPac
+        std::vector<uint8_t> mQual;     ///< quality scores, format depends on mQualMode
+        uint32_t mLen;                  ///< length of the sequence
+        uint32_t mQualLen;              ///< length of the quality string stored, may differ from mLen
+        uint8_t mQualMode;              ///< quality score storage mode
+        char mStrand;                   ///< strand of the sequence. Default is '*'
+
+    public:
+        /** Construct an empty packed sequence */
+        PackedSeq() : mLen(0), mQualLen(0), mQualMode(QUAL_NONE), mStrand('*') {}
+
+        /** Construct a packed sequence from an unaligned sequence
+         * @param us UnalignedSeq to be packed
+         * @param qualMode quality score storage mode
+         */
+        PackedSeq(const UnalignedSeq& us, QualMode qualMode = QUAL_NONE) : mName(us.mName), mComment(us.mComment), mStrand(us.mStrand) {
+            setSeq(us.mSeq);
+            setQual(us.mQual, qualMode);
+        }
+
+        /** Construct a packed sequence with name and sequence
+         * @param n name of the sequence
+         * @param s sequence
+         */
+        PackedSeq(const std::string& n, const std::string& s) : mName(n), mStrand('*') {
+            setSeq(s);
+            setQual(std::string(), QUAL_NONE);
+        }
+
+        /** get length of the sequence
+         * @return length of the sequence
+         */
+        inline size_t length() const {
+            return mLen;
+        }
+
+        /** get 2 bits code of a base, non-ACGT bases are coded as A
+         * @param i offset of the base
+         * @return 0/1/2/3 for A/C/G/T
+         */
+        inline uint8_t code(size_t i) const {
+            return mPac[i >> 2] >> ((~i & 3) << 1) & 3;
+        }
+
+        /** pack a sequence, lower case acgt are stored as upper case
+         * @param s sequence
+         */
+        inline void setSeq(const std::string& s){
+            mLen = s.length();
+            mPac.assign((s.length() + 3) >> 2, 0);
+            mAmbs.clear();
+            const uint8_t* nt4 = ntutil::getNt4Table();
+            for(size_t i = 0; i < s.length(); ++i){
+                uint8_t c = nt4[(uint8_t)s[i]];
+                if(c > 3){
+                    char b = std::toupper(s[i]);
+                    if(!mAmbs.empty() && mAmbs.back().base == b && mAmbs.back().offset + mAmbs.back().len == i){
+                        ++mAmbs.back().len;
+                    }else{
+                        mAmbs.push_back({(uint32_t)i, 1, b});
+                    }
+                    c = 0;
+                }
+                mPac[i >> 2] |= c << ((~i & 3) << 1);
+            }
+            mPac.shrink_to_fit();
+            mAmbs.shrink_to_fit();
+        }
+
+        /** store quality scores
+         * @param q quality string, phred+33
+         * @param qualMode quality score storage mode
+         */
+        inline void setQual(const std::string& q, QualMode qualMode){
+            mQualMode = q.empty() ? QUAL_NONE : qualMode;
+            mQualLen = mQualMode == QUAL_NONE ? 0 : q.length();
+            mQual.clear();
+            if(mQualMode == QUAL_FULL){
+                mQual.assign(q.begin(), q.end());
+            }else if(mQualMode == QUAL_BIN){
+                mQual.assign((q.length() + 1) >> 1, 0);
+                for(size_t i = 0; i < q.length(); ++i){
+                    mQual[i >> 1] |= qual2bin(q[i] - 33) << ((~i & 1) << 2);
+                }
+            }
+            mQual.shrink_to_fit();
+        }
+
+        /** unpack sequence to string, 4 bases a time
+         * @return sequence in upper case
+         */
+        inline std::string getSeq() const {
+            std::string s(mLen, 'A');
+            ntutil::unpackNt4(mPac.data(), mLen, &s[0]);
+            for(auto& a: mAmbs){
+                std::memset(&s[a.offset], a.base, a.len);
+            }
+            return s;
+        }
+
+        /** unpack quality scores to string, binned quality scores are restored to representative values of bins
+         * @return quality string, phred+33, empty if quality scores dropped
+         */
+        inline std::string getQual() const {
+            if(mQualMode == QUAL_FULL){
+                return std::string(mQual.begin(), mQual.end());
+            }
+            std::string q;
+            if(mQualMode == QUAL_BIN){
+                static const char reps[8] = {1, 6, 15, 22, 27, 33, 37, 40};
+                q.resize(mQualLen);
+                for(size_t i = 0; i < mQualLen; ++i){
+                    q[i] = reps[mQual[i >> 1] >> ((~i & 1) << 2) & 0xf] + 33;
+                }
+            }
+            return q;
+        }
+
+        /** unpack to UnalignedSeq
+         * @return UnalignedSeq
+         */
+        inline UnalignedSeq unpack() const {
+            UnalignedSeq us(mName, getSeq(), getQual(), mStrand);
+            us.mComment = mComment;
+            return us;
+        }
+
+        /** get Bytes of heap memory used by sequence and quality scores
+         * @return Bytes used
+         */
+        inline size_t memoryUsage() const {
+            return mPac.capacity() + mAmbs.capacity() * sizeof(PackedAmb) + mQual.capacity();
+        }
+
+        /** get bin of a quality score, bins are Q0-1, Q2-9, Q10-19, Q20-24, Q25-29, Q30-34, Q35-39 and Q40+
+         * @param q quality score
+         * @return bin index 0-7
+         */
+        inline static uint8_t qual2bin(int q){
+            static const int bounds[7] = {2, 10, 20, 25, 30, 35, 40};
+            uint8_t b = 0;
+            while(b < 7 && q >= bounds[b]){
+                ++b;
+            }
+            return b;
+        }
+};
+
 #endif
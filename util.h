@@ -8,6 +8,10 @@
 #endif
 
 #include <string>
+#include <string_view>
+#include <charconv>
+#include <cstring>
+#include <cstdint>
 #include <cerrno>
 #include <cstdio>
 #include <cctype>
@@ -21,6 +25,10 @@
 #include <functional>
 #include <dirent.h>
 #include <sys/stat.h>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define UTIL_X86_SIMD
+#endif
 
 /** utility to operate on strings and directories */
 namespace util{
@@ -29,12 +37,8 @@ namespace util{
      * @param pre substring
      * @return true if str starts with pre
      */
-    inline bool startsWith(const std::string& str, const std::string& pre){
-        if(str.length() < pre.length()){
-            return false;
-        }else{
-            return std::equal(pre.begin(), pre.end(), str.begin());
-        }
+    inline bool startsWith(std::string_view str, std::string_view pre){
+        return str.length() >= pre.length() && str.compare(0, pre.length(), pre) == 0;
     }
 
     /** whether a string ends with some substring
@@ -42,12 +46,44 @@ namespace util{
      * @param suf substring
      * @return true if str ends with suf
      */
-    inline bool endsWith(const std::string& str, const std::string& suf){
-        if(str.length() < suf.length()){
-            return false;
-        }else{
-            return std::equal(suf.rbegin(), suf.rend(), str.rbegin());
+    inline bool endsWith(std::string_view str, std::string_view suf){
+        return str.length() >= suf.length() && str.compare(str.length() - suf.length(), suf.length(), suf) == 0;
+    }
+
+    /** get a view of a string without the leading and ending white space characters, nothing is copied
+     * @param str string to be stripped in both ends
+     * @return a view of str with white spaces stripped in both ends
+     */
+    inline std::string_view stripView(std::string_view str){
+        std::string_view::size_type ipos = str.find_first_not_of(" \t\n\v\f\r");
+        if(ipos == std::string_view::npos){
+            return std::string_view();
+        }
+        return str.substr(ipos, str.find_last_not_of(" \t\n\v\f\r") - ipos + 1);
+    }
+
+    /** get a view of a string without the left leading white space characters, nothing is copied
+     * @param str string to be stripped from front
+     * @return a view of str with left leading white spaces stripped
+     */
+    inline std::string_view lstripView(std::string_view str){
+        std::string_view::size_type pos = str.find_first_not_of(" \t\n\v\f\r");
+        if(pos == std::string_view::npos){
+            return std::string_view();
         }
+        return str.substr(pos);
+    }
+
+    /** get a view of a string without the trailling white space characters, nothing is copied
+     * @param str string to be stripped from back
+     * @return a view of str with right ending white spaces stripped
+     */
+    inline std::string_view rstripView(std::string_view str){
+        std::string_view::size_type pos = str.find_last_not_of(" \t\n\v\f\r");
+        if(pos == std::string_view::npos){
+            return std::string_view();
+        }
+        return str.substr(0, pos + 1);
     }
 
     /** get rid of the leading and ending white space characters of a string
@@ -55,16 +91,7 @@ namespace util{
      * @return a string with white spaces stripped in both ends
      */
     inline std::string strip(const std::string& str){
-        std::string::size_type ipos = str.find_first_not_of(" \t\n\v\f\r");
-        if(ipos == std::string::npos){
-            return "";
-        }
-        std::string::size_type epos = str.find_last_not_of(" \t\n\v\f\r");
-        if(epos == ipos){
-            return str.substr(ipos);
-        }else{
-            return str.substr(ipos, epos - ipos + 1);
-        }
+        return std::string(stripView(str));
     }
 
     /** get rid of the left leading white space characters of a string
@@ -72,11 +99,7 @@ namespace util{
      * @return a string with left leading white spaces stripped
      */
     inline std::string lstrip(const std::string& str){
-        std::string::size_type pos = str.find_first_not_of(" \t\n\v\f\r");
-        if(pos == std::string::npos){
-            return "";
-        }
-        return str.substr(pos);
+        return std::string(lstripView(str));
     }
 
     /** get rid of the trailling white space characters of a string
@@ -84,11 +107,7 @@ namespace util{
      * @return a string with right ending white spaces stripped
      */
     inline std::string rstrip(const std::string& str){
-        std::string::size_type pos = str.find_last_not_of(" \t\n\v\f\r");
-        if(pos == std::string::npos){
-           return "";
-        }
-        return str.substr(0, pos + 1);
+        return std::string(rstripView(str));
     } 
 
     /** split a string by predefined seperator into a vector
@@ -111,6 +130,100 @@ namespace util{
             las = cur;
         }
     }
+
+    /** split a string by a single seperator character into a vector of views without allocating any string\n
+     * unlike split, empty fields between two adjacent seperators are kept, as needed by tsv columns\n
+     * the views point into str and are invalidated once str is modified or destroyed
+     * @param str string
+     * @param vec vector to store the split results
+     * @param sep seperator character
+     * @param maxFields stop splitting after maxFields - 1 fields, the last field holds the remaining part, 0 for no limit
+     */
+    inline void splitView(std::string_view str, std::vector<std::string_view>& vec, char sep = '\t', size_t maxFields = 0){
+        vec.clear();
+        const char* beg = str.data();
+        const char* end = beg + str.size();
+        while(maxFields == 0 || vec.size() + 1 < maxFields){
+            const char* pos = (const char*)std::memchr(beg, sep, end - beg);
+            if(pos == NULL){
+                break;
+            }
+            vec.emplace_back(beg, pos - beg);
+            beg = pos + 1;
+        }
+        vec.emplace_back(beg, end - beg);
+    }
+
+    /** split a string by predefined seperators into a vector of views without allocating any string\n
+     * same as split, a series of adjacent seperators are treated as one
+     * @param str string
+     * @param vec vector to store the split results
+     * @param sep seperators, can contain a series of seperators
+     */
+    inline void splitView(std::string_view str, std::vector<std::string_view>& vec, std::string_view sep){
+        vec.clear();
+        std::string_view::size_type las, cur;
+        las = 0;
+        while((las = str.find_first_not_of(sep, las)) != std::string_view::npos){
+            cur = str.find_first_of(sep, las);
+            if(cur != std::string_view::npos){
+                vec.push_back(str.substr(las, cur - las));
+            }else{
+                vec.push_back(str.substr(las));
+                break;
+            }
+            las = cur;
+        }
+    }
+
+    /** parse the leading number of a string without allocation or locale lookup\n
+     * leading white spaces and a '+' sign are skipped as std::atoi/std::atof do
+     * @param str string starting with an integer or floating point number
+     * @param val number to store the result, unchanged if no number parsed
+     * @return pointer past the last character parsed, NULL if no number parsed
+     */
+    template<typename T>
+    inline const char* str2numPrefix(std::string_view str, T& val){
+        const char* beg = str.data();
+        const char* end = beg + str.size();
+        while(beg < end && std::isspace((unsigned char)*beg)){
+            ++beg;
+        }
+        if(beg + 1 < end && beg[0] == '+' && beg[1] != '-'){
+            ++beg;
+        }
+        auto ret = std::from_chars(beg, end, val);
+        return ret.ec == std::errc() ? ret.ptr : NULL;
+    }
+
+    /** convert a string to a number without allocation or locale lookup, leading white spaces are skipped
+     * @param str string of an integer or floating point number
+     * @param val number to store the result, unchanged if conversion fails
+     * @return true if the whole str converted successfully
+     */
+    template<typename T>
+    inline bool str2num(std::string_view str, T& val){
+        T tmp{};
+        const char* pos = str2numPrefix(str, tmp);
+        if(pos == NULL || pos != str.data() + str.size()){
+            return false;
+        }
+        val = tmp;
+        return true;
+    }
+
+    /** convert a string to a number without allocation or locale lookup, like std::atoi/std::atof but typed\n
+     * leading white spaces are skipped and trailing characters are ignored, so "12abc" is converted to 12
+     * @param str string starting with an integer or floating point number
+     * @return converted number, 0 if no number parsed
+     */
+    template<typename T = int32_t>
+    inline T str2num(std::string_view str){
+        T val = 0;
+        str2numPrefix(str, val);
+        return val;
+    }
+
     /** join a list of strings by an seperator
      * @param vec vector to store the split results
      * @param ret joined string
@@ -147,6 +260,28 @@ namespace util{
         return ret;
     }
 
+    /** replace a substr apearing in a string with another string into an output string\n
+     * memory of out is reused, so no allocation happens once out is large enough
+     * @param str string, must not overlap with out
+     * @param pat substr of string to be replaced, nothing replaced if empty
+     * @param des string to be used to replaced with pat
+     * @param out store str with each pat replaced by des
+     */
+    inline void replace(std::string_view str, std::string_view pat, std::string_view des, std::string& out){
+        out.clear();
+        if(pat.empty()){
+            out.append(str);
+            return;
+        }
+        std::string_view::size_type las = 0, cur = 0;
+        while((cur = str.find(pat, las)) != std::string_view::npos){
+            out.append(str, las, cur - las);
+            out.append(des);
+            las = cur + pat.length();
+        }
+        out.append(str, las);
+    }
+
     /** replace a substr apearing in a string with another string
      * @param str string 
      * @param pat substr of string to be replaced
@@ -155,16 +290,7 @@ namespace util{
      */
     inline std::string replace(const std::string& str, const std::string& pat, const std::string& des){
         std::string ret;
-        std::string::size_type las = 0, cur = 0;
-        while((cur = str.find(pat, cur)) != std::string::npos){
-            ret.append(str.substr(las, cur - las));
-            ret.append(des);
-            cur += pat.length();
-            las = cur;
-        }
-        if(las != std::string::npos){
-            ret.append(str.substr(las));
-        }
+        util::replace(str, pat, des, ret);
         return ret;
     }
 
@@ -240,6 +366,55 @@ namespace util{
         }
     }
 
+    /** get a view of the basename of a path string, nothing is copied and '~' is not expanded
+     * @param path name
+     * @return view of basename in path
+     */
+    inline std::string_view basenameView(std::string_view path){
+        for(char c: path){
+            if(c == ' ' || (c >= '\t' && c <= '\r')){
+                return std::string_view();
+            }
+        }
+        std::string_view::size_type pos2 = path.find_last_not_of("/\\");
+        if(pos2 == std::string_view::npos){
+            return std::string_view();
+        }
+        std::string_view::size_type pos3 = path.find_last_of("/\\", pos2);
+        if(pos3 == std::string_view::npos){
+            return path.substr(0, pos2 + 1);
+        }
+        return path.substr(pos3 + 1, pos2 - pos3);
+    }
+
+    /** get a view of the dirname of a path string, nothing is copied and '~' is not expanded
+     * @param path name
+     * @return view of dirname in path, or a static "./" if path has no directory part
+     */
+    inline std::string_view dirnameView(std::string_view path){
+#ifdef _WIN32
+        const std::string_view cur = ".\\", root = "\\";
+#else
+        const std::string_view cur = "./", root = "/";
+#endif
+        std::string_view::size_type pos = path.find_last_of("/\\");
+        if(pos == std::string_view::npos){
+            return cur;
+        }
+        if(pos == path.size() - 1){
+            std::string_view::size_type pos1 = path.find_last_not_of("/\\");
+            if(pos1 == std::string_view::npos){
+                return root;
+            }
+            std::string_view::size_type pos2 = path.find_last_of("/\\", pos1);
+            if(pos2 == std::string_view::npos){
+                return cur;
+            }
+            return path.substr(0, pos2 + 1);
+        }
+        return path.substr(0, pos + 1);
+    }
+
     /** get absolute path of a path
      * @param path string of path
      * @return absolute path string
@@ -386,13 +561,26 @@ namespace util{
         }
     }
 
+    /** remove non-alpha characters from a string into an output string, memory of out is reused
+     * @param str string to be filtered, must not overlap with out
+     * @param out store str without non-alpha characters
+     */
+    inline void getAlpha(std::string_view str, std::string& out){
+        out.clear();
+        for(auto& c: str){
+            if(std::isalpha((unsigned char)c)){
+                out.push_back(c);
+            }
+        }
+    }
+
     /** remove non-alpha characters from a string
      * @param str string to be filtered
      * @return a string without non-alpha characters
      */
     inline std::string getAlpha(const std::string& str){
         std::string ret;
-        std::copy_if(str.cbegin(), str.cend(), std::back_inserter(ret), (int(*)(int))std::isalpha);
+        getAlpha(str, ret);
         return ret;
     }
 
@@ -424,19 +612,6 @@ namespace util{
         std::transform(str.begin(), str.end(), str.begin(), (int (*)(int))std::tolower);
     }
 
-    /** get hamming distance of two strings
-     * @param str1 string 1
-     * @param str2 string 2
-     * @return hamming distance of string 1 and string 2
-     */
-    inline int hamming(const std::string& str1, const std::string& str2){
-        int diff = std::abs((int)(str1.size() - str2.size()));
-        for(uint16_t i = 0; i < std::min(str1.size(), str2.size()); ++i){
-            diff += (str1[i] == str2[i] ? 0 : 1);
-        }
-        return diff;
-    }
-
     /** convert number to 33 based score character
      * @param num number of score
      * @return 33 based score character
@@ -466,62 +641,443 @@ namespace util{
         return qstr;
     }
 
+    /** get table to complement nucleotide bases
+     * @param iupac if true complement IUPAC codes and keep case, other characters are kept as they are,\n
+     * else complement ACGT/acgt to uppercased bases and others to N, like complement does
+     * @return pointer to table of 256 entries
+     */
+    inline const char* getComplementTable(bool iupac = false){
+        static const struct ComplementTable{
+            char acgt[256];
+            char iupac[256];
+            ComplementTable(){
+                const char* fwd = "ACGTURYKMBVDHSWN";
+                const char* rev = "TGCAAYRMKVBHDSWN";
+                for(int i = 0; i < 256; ++i){
+                    acgt[i] = 'N';
+                    iupac[i] = (char)i;
+                }
+                for(int i = 0; fwd[i]; ++i){
+                    iupac[(uint8_t)fwd[i]] = rev[i];
+                    iupac[(uint8_t)std::tolower(fwd[i])] = std::tolower(rev[i]);
+                }
+                for(int i = 0; i < 4; ++i){
+                    acgt[(uint8_t)fwd[i]] = acgt[(uint8_t)std::tolower(fwd[i])] = rev[i];
+                }
+            }
+        } table;
+        return iupac ? table.iupac : table.acgt;
+    }
+
     /** get complement base of a nucleotide base
      * @param base nucleotide base character
      * @return the uppercased complementary nucleotide base
      */
     inline char complement(char base){
-        switch(base){
-            case 'A': case 'a':
-                return 'T';
-            case 'T': case 't':
-                return 'A';
-            case 'C': case 'c':
-                return 'G';
-            case 'G': case 'g':
-                return 'C';
-            default:
-                return 'N';
+        return getComplementTable()[(uint8_t)base];
+    }
+
+    /** complement or reverse complement a sequence one base at a time
+     * @param in input sequence
+     * @param out output sequence of len bases, can be the same as in if not reverse
+     * @param len length of the sequence
+     * @param reverse reverse complement if true
+     * @param iupac complement IUPAC codes and keep case if true, see getComplementTable
+     */
+    inline void complementScalar(const char* in, char* out, size_t len, bool reverse, bool iupac){
+        const char* table = getComplementTable(iupac);
+        if(reverse){
+            for(size_t i = 0; i < len; ++i){
+                out[i] = table[(uint8_t)in[len - 1 - i]];
+            }
+        }else{
+            for(size_t i = 0; i < len; ++i){
+                out[i] = table[(uint8_t)in[i]];
+            }
+        }
+    }
+
+    /** reverse complement a sequence in place one base at a time
+     * @param seq sequence
+     * @param len length of the sequence
+     * @param iupac complement IUPAC codes and keep case if true, see getComplementTable
+     */
+    inline void reverseComplementScalar(char* seq, size_t len, bool iupac){
+        const char* table = getComplementTable(iupac);
+        for(size_t i = 0, j = len; i < j--; ++i){
+            char c = table[(uint8_t)seq[i]];
+            seq[i] = table[(uint8_t)seq[j]];
+            seq[j] = c;
+        }
+    }
+
+#ifdef UTIL_X86_SIMD
+    /** complement 16 bases, ACGT/acgt are looked up by low 4 bits of uppercased bases
+     * @param v 16 bases
+     * @param iupac keep case if true, else complement non-ACGT bases to N
+     * @param ok set to false if iupac and any base is not ACGT/acgt, the result is invalid then
+     * @return complemented bases
+     */
+    __attribute__((target("ssse3")))
+    inline __m128i complementBlockSSSE3(__m128i v, bool iupac, bool& ok){
+        const __m128i fwd = _mm_setr_epi8(-1, 'A', -1, 'C', 'T', -1, -1, 'G', -1, -1, -1, -1, -1, -1, -1, -1);
+        const __m128i rev = _mm_setr_epi8(-1, 'T', -1, 'G', 'A', -1, -1, 'C', -1, -1, -1, -1, -1, -1, -1, -1);
+        __m128i upper = _mm_and_si128(v, _mm_set1_epi8((char)0xdf));
+        __m128i idx = _mm_and_si128(upper, _mm_set1_epi8(0x0f));
+        __m128i isACGT = _mm_cmpeq_epi8(_mm_shuffle_epi8(fwd, idx), upper);
+        __m128i comp = _mm_shuffle_epi8(rev, idx);
+        if(iupac){
+            ok = _mm_movemask_epi8(isACGT) == 0xffff;
+            return _mm_or_si128(comp, _mm_and_si128(v, _mm_set1_epi8(0x20)));
+        }
+        ok = true;
+        return _mm_or_si128(_mm_and_si128(isACGT, comp), _mm_andnot_si128(isACGT, _mm_set1_epi8('N')));
+    }
+
+    /** reverse 16 bases
+     * @param v 16 bases
+     * @return reversed bases
+     */
+    __attribute__((target("ssse3")))
+    inline __m128i reverseBlockSSSE3(__m128i v){
+        return _mm_shuffle_epi8(v, _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0));
+    }
+
+    /** complement or reverse complement a sequence 16 bases at a time
+     * @param in input sequence
+     * @param out output sequence of len bases, can be the same as in if not reverse
+     * @param len length of the sequence
+     * @param reverse reverse complement if true
+     * @param iupac complement IUPAC codes and keep case if true, see getComplementTable
+     */
+    __attribute__((target("ssse3")))
+    inline void complementSSSE3(const char* in, char* out, size_t len, bool reverse, bool iupac){
+        size_t i = 0;
+        for(; i + 16 <= len; i += 16){
+            const char* src = reverse ? in + len - i - 16 : in + i;
+            bool ok = true;
+            __m128i v = complementBlockSSSE3(_mm_loadu_si128((const __m128i*)src), iupac, ok);
+            if(!ok){
+                complementScalar(src, out + i, 16, reverse, iupac);
+                continue;
+            }
+            _mm_storeu_si128((__m128i*)(out + i), reverse ? reverseBlockSSSE3(v) : v);
+        }
+        complementScalar(reverse ? in : in + i, out + i, len - i, reverse, iupac);
+    }
+
+    /** reverse complement a sequence in place, 16 bases from each end at a time
+     * @param seq sequence
+     * @param len length of the sequence
+     * @param iupac complement IUPAC codes and keep case if true, see getComplementTable
+     */
+    __attribute__((target("ssse3")))
+    inline void reverseComplementSSSE3(char* seq, size_t len, bool iupac){
+        char* beg = seq;
+        char* end = seq + len;
+        while(end - beg >= 32){
+            bool ok1 = true, ok2 = true;
+            __m128i head = complementBlockSSSE3(_mm_loadu_si128((const __m128i*)beg), iupac, ok1);
+            __m128i tail = complementBlockSSSE3(_mm_loadu_si128((const __m128i*)(end - 16)), iupac, ok2);
+            if(ok1 && ok2){
+                _mm_storeu_si128((__m128i*)beg, reverseBlockSSSE3(tail));
+                _mm_storeu_si128((__m128i*)(end - 16), reverseBlockSSSE3(head));
+            }else{
+                const char* table = getComplementTable(iupac);
+                for(int k = 0; k < 16; ++k){
+                    char c = table[(uint8_t)beg[k]];
+                    beg[k] = table[(uint8_t)end[-1 - k]];
+                    end[-1 - k] = c;
+                }
+            }
+            beg += 16;
+            end -= 16;
+        }
+        reverseComplementScalar(beg, end - beg, iupac);
+    }
+
+    /** complement 32 bases, see complementBlockSSSE3
+     * @param v 32 bases
+     * @param iupac keep case if true, else complement non-ACGT bases to N
+     * @param ok set to false if iupac and any base is not ACGT/acgt, the result is invalid then
+     * @return complemented bases
+     */
+    __attribute__((target("avx2")))
+    inline __m256i complementBlockAVX2(__m256i v, bool iupac, bool& ok){
+        const __m256i fwd = _mm256_setr_epi8(-1, 'A', -1, 'C', 'T', -1, -1, 'G', -1, -1, -1, -1, -1, -1, -1, -1,
+                                             -1, 'A', -1, 'C', 'T', -1, -1, 'G', -1, -1, -1, -1, -1, -1, -1, -1);
+        const __m256i rev = _mm256_setr_epi8(-1, 'T', -1, 'G', 'A', -1, -1, 'C', -1, -1, -1, -1, -1, -1, -1, -1,
+                                             -1, 'T', -1, 'G', 'A', -1, -1, 'C', -1, -1, -1, -1, -1, -1, -1, -1);
+        __m256i upper = _mm256_and_si256(v, _mm256_set1_epi8((char)0xdf));
+        __m256i idx = _mm256_and_si256(upper, _mm256_set1_epi8(0x0f));
+        __m256i isACGT = _mm256_cmpeq_epi8(_mm256_shuffle_epi8(fwd, idx), upper);
+        __m256i comp = _mm256_shuffle_epi8(rev, idx);
+        if(iupac){
+            ok = (uint32_t)_mm256_movemask_epi8(isACGT) == 0xffffffffu;
+            return _mm256_or_si256(comp, _mm256_and_si256(v, _mm256_set1_epi8(0x20)));
+        }
+        ok = true;
+        return _mm256_blendv_epi8(_mm256_set1_epi8('N'), comp, isACGT);
+    }
+
+    /** reverse 32 bases
+     * @param v 32 bases
+     * @return reversed bases
+     */
+    __attribute__((target("avx2")))
+    inline __m256i reverseBlockAVX2(__m256i v){
+        const __m256i idx = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+                                             15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+        return _mm256_permute4x64_epi64(_mm256_shuffle_epi8(v, idx), 0x4e);
+    }
+
+    /** complement or reverse complement a sequence 32 bases at a time
+     * @param in input sequence
+     * @param out output sequence of len bases, can be the same as in if not reverse
+     * @param len length of the sequence
+     * @param reverse reverse complement if true
+     * @param iupac complement IUPAC codes and keep case if true, see getComplementTable
+     */
+    __attribute__((target("avx2")))
+    inline void complementAVX2(const char* in, char* out, size_t len, bool reverse, bool iupac){
+        size_t i = 0;
+        for(; i + 32 <= len; i += 32){
+            const char* src = reverse ? in + len - i - 32 : in + i;
+            bool ok = true;
+            __m256i v = complementBlockAVX2(_mm256_loadu_si256((const __m256i*)src), iupac, ok);
+            if(!ok){
+                complementScalar(src, out + i, 32, reverse, iupac);
+                continue;
+            }
+            _mm256_storeu_si256((__m256i*)(out + i), reverse ? reverseBlockAVX2(v) : v);
         }
+        complementSSSE3(reverse ? in : in + i, out + i, len - i, reverse, iupac);
+    }
+
+    /** reverse complement a sequence in place, 32 bases from each end at a time
+     * @param seq sequence
+     * @param len length of the sequence
+     * @param iupac complement IUPAC codes and keep case if true, see getComplementTable
+     */
+    __attribute__((target("avx2")))
+    inline void reverseComplementAVX2(char* seq, size_t len, bool iupac){
+        char* beg = seq;
+        char* end = seq + len;
+        while(end - beg >= 64){
+            bool ok1 = true, ok2 = true;
+            __m256i head = complementBlockAVX2(_mm256_loadu_si256((const __m256i*)beg), iupac, ok1);
+            __m256i tail = complementBlockAVX2(_mm256_loadu_si256((const __m256i*)(end - 32)), iupac, ok2);
+            if(ok1 && ok2){
+                _mm256_storeu_si256((__m256i*)beg, reverseBlockAVX2(tail));
+                _mm256_storeu_si256((__m256i*)(end - 32), reverseBlockAVX2(head));
+            }else{
+                const char* table = getComplementTable(iupac);
+                for(int k = 0; k < 32; ++k){
+                    char c = table[(uint8_t)beg[k]];
+                    beg[k] = table[(uint8_t)end[-1 - k]];
+                    end[-1 - k] = c;
+                }
+            }
+            beg += 32;
+            end -= 32;
+        }
+        reverseComplementSSSE3(beg, end - beg, iupac);
+    }
+#endif
+
+    /** get simd level supported by cpu, shared by all runtime dispatched kernels
+     * @return 2 for avx2, 1 for ssse3, 0 for none
+     */
+    inline int getSimdLevel(){
+#ifdef UTIL_X86_SIMD
+        static const int level = []{
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") ? 2 : (__builtin_cpu_supports("ssse3") ? 1 : 0);
+        }();
+        return level;
+#else
+        return 0;
+#endif
+    }
+
+    /** complement or reverse complement a sequence with the fastest kernel supported by cpu at runtime
+     * @param in input sequence
+     * @param out output sequence of len bases, can be the same as in if not reverse
+     * @param len length of the sequence
+     * @param reverse reverse complement if true
+     * @param iupac complement IUPAC codes and keep case if true, see getComplementTable
+     */
+    inline void complement(const char* in, char* out, size_t len, bool reverse, bool iupac = false){
+#ifdef UTIL_X86_SIMD
+        int level = getSimdLevel();
+        if(level == 2){
+            return complementAVX2(in, out, len, reverse, iupac);
+        }
+        if(level == 1){
+            return complementSSSE3(in, out, len, reverse, iupac);
+        }
+#endif
+        complementScalar(in, out, len, reverse, iupac);
+    }
+
+    /** reverse complement a sequence in place with the fastest kernel supported by cpu at runtime
+     * @param seq sequence
+     * @param len length of the sequence
+     * @param iupac complement IUPAC codes and keep case if true, see getComplementTable
+     */
+    inline void reverseComplement(char* seq, size_t len, bool iupac = false){
+#ifdef UTIL_X86_SIMD
+        int level = getSimdLevel();
+        if(level == 2){
+            return reverseComplementAVX2(seq, len, iupac);
+        }
+        if(level == 1){
+            return reverseComplementSSSE3(seq, len, iupac);
+        }
+#endif
+        reverseComplementScalar(seq, len, iupac);
+    }
+
+    /** count mismatched characters of two sequences one character at a time
+     * @param s1 sequence 1
+     * @param s2 sequence 2
+     * @param len number of characters to compare
+     * @param skipN positions where either sequence has N are not counted if true
+     * @return number of mismatched characters
+     */
+    inline size_t countMismatchScalar(const char* s1, const char* s2, size_t len, bool skipN){
+        size_t diff = 0;
+        for(size_t i = 0; i < len; ++i){
+            diff += (s1[i] != s2[i] && !(skipN && (s1[i] == 'N' || s2[i] == 'N')));
+        }
+        return diff;
+    }
+
+#ifdef UTIL_X86_SIMD
+    /** count mismatched characters of two sequences 16 characters at a time
+     * @param s1 sequence 1
+     * @param s2 sequence 2
+     * @param len number of characters to compare
+     * @param skipN positions where either sequence has N are not counted if true
+     * @return number of mismatched characters
+     */
+    __attribute__((target("sse2")))
+    inline size_t countMismatchSSE2(const char* s1, const char* s2, size_t len, bool skipN){
+        const __m128i n = _mm_set1_epi8('N');
+        size_t diff = 0;
+        size_t i = 0;
+        for(; i + 16 <= len; i += 16){
+            __m128i v1 = _mm_loadu_si128((const __m128i*)(s1 + i));
+            __m128i v2 = _mm_loadu_si128((const __m128i*)(s2 + i));
+            __m128i same = _mm_cmpeq_epi8(v1, v2);
+            if(skipN){
+                same = _mm_or_si128(same, _mm_or_si128(_mm_cmpeq_epi8(v1, n), _mm_cmpeq_epi8(v2, n)));
+            }
+            diff += 16 - __builtin_popcount(_mm_movemask_epi8(same));
+        }
+        return diff + countMismatchScalar(s1 + i, s2 + i, len - i, skipN);
+    }
+
+    /** count mismatched characters of two sequences 32 characters at a time
+     * @param s1 sequence 1
+     * @param s2 sequence 2
+     * @param len number of characters to compare
+     * @param skipN positions where either sequence has N are not counted if true
+     * @return number of mismatched characters
+     */
+    __attribute__((target("avx2,popcnt")))
+    inline size_t countMismatchAVX2(const char* s1, const char* s2, size_t len, bool skipN){
+        const __m256i n = _mm256_set1_epi8('N');
+        size_t diff = 0;
+        size_t i = 0;
+        for(; i + 32 <= len; i += 32){
+            __m256i v1 = _mm256_loadu_si256((const __m256i*)(s1 + i));
+            __m256i v2 = _mm256_loadu_si256((const __m256i*)(s2 + i));
+            __m256i same = _mm256_cmpeq_epi8(v1, v2);
+            if(skipN){
+                same = _mm256_or_si256(same, _mm256_or_si256(_mm256_cmpeq_epi8(v1, n), _mm256_cmpeq_epi8(v2, n)));
+            }
+            diff += 32 - __builtin_popcount((uint32_t)_mm256_movemask_epi8(same));
+        }
+        return diff + countMismatchSSE2(s1 + i, s2 + i, len - i, skipN);
+    }
+#endif
+
+    /** count mismatched characters of two sequences with the fastest kernel supported by cpu at runtime,\n
+     * SSE2 is part of the x86-64 baseline so it is used unless getSimdLevel reports AVX2
+     * @param s1 sequence 1
+     * @param s2 sequence 2
+     * @param len number of characters to compare
+     * @param skipN positions where either sequence has N are not counted if true
+     * @return number of mismatched characters
+     */
+    inline size_t countMismatch(const char* s1, const char* s2, size_t len, bool skipN = false){
+#ifdef UTIL_X86_SIMD
+        if(getSimdLevel() == 2){
+            return countMismatchAVX2(s1, s2, len, skipN);
+        }
+#ifdef __SSE2__
+        return countMismatchSSE2(s1, s2, len, skipN);
+#endif
+#endif
+        return countMismatchScalar(s1, s2, len, skipN);
+    }
+
+    /** get hamming distance of two strings
+     * @param str1 string 1
+     * @param str2 string 2
+     * @return hamming distance of string 1 and string 2, length difference counted as mismatches
+     */
+    inline int hamming(const std::string& str1, const std::string& str2){
+        size_t minLen = std::min(str1.size(), str2.size());
+        return countMismatch(str1.data(), str2.data(), minLen) + std::max(str1.size(), str2.size()) - minLen;
+    }
+
+    /** get hamming distances of a query string to many strings, like a read barcode to a whitelist
+     * @param query query string
+     * @param targets strings to compare query to
+     * @param dists store hamming distance of query to each target, length difference counted as mismatches
+     * @return index of the first target with the smallest distance, -1 if targets is empty
+     */
+    inline int hamming(const std::string& query, const std::vector<std::string>& targets, std::vector<int>& dists){
+        dists.resize(targets.size());
+        int best = -1;
+        for(size_t i = 0; i < targets.size(); ++i){
+            dists[i] = hamming(query, targets[i]);
+            if(best < 0 || dists[i] < dists[best]){
+                best = i;
+            }
+        }
+        return best;
     }
 
     /** get reverse completement sequence of a nucleotide sequence
      * @param seq a nucleotide sequence
+     * @param iupac complement IUPAC codes and keep case if true, see getComplementTable
      * @return the reverse completement sequence of seq
      */
-    inline std::string reverseComplement(const std::string& seq){
+    inline std::string reverseComplement(const std::string& seq, bool iupac = false){
         std::string retSeq(seq.length(), '\0');
-        for(int32_t i = retSeq.length() - 1; i >= 0; --i){
-            retSeq[i] = complement(seq[seq.length() - 1 - i]);
-        }
+        complement(seq.data(), &retSeq[0], seq.length(), true, iupac);
         return retSeq;
     }
     
     /** reverse completement an sequence of a nucleotide sequence
      * @param seq a nucleotide sequence to be reverse complemented
+     * @param iupac complement IUPAC codes and keep case if true, see getComplementTable
      */
-    inline void reverseComplement(std::string& seq){
-        int32_t i = seq.size() - 1;
-        int32_t j = 0;
-        char tmpChr = '\0';
-        while(j <= i){
-            tmpChr = complement(seq[i]);
-            seq[i] = complement(seq[j]);
-            seq[j] = tmpChr;
-            ++j;
-            --i;
-        }
+    inline void reverseComplement(std::string& seq, bool iupac = false){
+        reverseComplement(&seq[0], seq.length(), iupac);
     }
     
     /** get forward completment sequene of a nucleotide sequence
      * @param seq a nucleotide sequence
+     * @param iupac complement IUPAC codes and keep case if true, see getComplementTable
      * @return the forward completement sequence of seq
      */
-    inline std::string forwardComplement(const std::string& seq){
+    inline std::string forwardComplement(const std::string& seq, bool iupac = false){
         std::string retSeq(seq.length(), '\0');
-        for(uint32_t i = 0; i < retSeq.length(); ++i){
-            retSeq[i] = complement(seq[i]);
-        }
+        complement(seq.data(), &retSeq[0], seq.length(), false, iupac);
         return retSeq;
     }
 
@@ -656,41 +1212,29 @@ namespace util{
         return diff;
     }
     
-    /** get mismatch ratio of two uncleotide sequence
+    /** get mismatch ratio of two uncleotide sequence\n
+     * leading and trailing positions where either sequence has N are trimmed, inner N positions are not counted as mismatches
      * @param s1 nucleotide sequence
      * @param s2 nucleotide sequence
-     * @return mismatch ratio to the shorter string
+     * @return mismatch ratio to the trimmed shorter string, 1.0 if nothing left to compare
      */
     inline float mismatchRatio(const std::string& s1, const std::string& s2){
-        uint32_t minLen = std::min(s1.length(), s2.length());
+        size_t minLen = std::min(s1.length(), s2.length());
         if(minLen == 0 || s1.find_first_of("ATCG") == std::string::npos || s2.find_first_of("ATCG") == std::string::npos){
             return 1.0;
         }
-        if(minLen == 1){
-            return s1[0] == s2[0];
-        }
         size_t beg = 0;
-        for(beg = 0; beg < minLen; ++beg){
-            if(s1[beg] == 'N' || s2[beg] == 'N'){
-                ++beg;
-            }
+        while(beg < minLen && (s1[beg] == 'N' || s2[beg] == 'N')){
+            ++beg;
         }
-        size_t end = minLen - 1;
-        for(end = minLen - 1; end > beg; --end){
-            if(s1[end] == 'N' || s2[end] == 'N'){
-                --end;
-            }
+        size_t end = minLen;
+        while(end > beg && (s1[end - 1] == 'N' || s2[end - 1] == 'N')){
+            --end;
         }
-        int32_t mismatch = 0;
-        for(uint32_t i = beg; i <= end; ++i){
-            if(s1[i] == 'N' || s2[i] == 'N'){
-                continue;
-            }
-            if(s1[i] != s2[i]){
-                ++mismatch;
-            }
+        if(beg == end){
+            return 1.0;
         }
-        return float(mismatch)/(end - beg + 1);
+        return float(countMismatch(s1.data() + beg, s2.data() + beg, end - beg, true))/(end - beg);
     }
 
     /** get median of a list of values
@@ -716,11 +1260,16 @@ namespace util{
      * @param chrs characters to be found in str
      */
     inline int32_t countChrs(const std::string& str, const std::string& chrs){
+        if(chrs.length() == 1){
+            return std::count(str.begin(), str.end(), chrs[0]);
+        }
+        bool hit[256] = {false};
+        for(auto& c: chrs){
+            hit[(uint8_t)c] = true;
+        }
         int32_t count = 0;
-        std::string::size_type pos = 0;
-        while((pos = str.find_first_of(chrs, pos)) != std::string::npos){
-            ++pos;
-            ++count;
+        for(auto& c: str){
+            count += hit[(uint8_t)c];
         }
         return count;
     }
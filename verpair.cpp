@@ -0,0 +1,18 @@
+#include <cstdio>
+#include "pairedreader.h"
+
+int main(int argc, char *argv[])
+{
+	if (argc < 3) {
+		fprintf(stderr, "Usage: %s <r1.fasta> <r2.fasta> \n", argv[0]);
+		return 1;
+	}
+	PairedReader reader(argv[1], argv[2]);
+	SeqPairBatch batch;
+	while (reader.read(batch)) {
+		for (int i : batch.mismatch) {
+			printf("name: %s\t%s\n", batch.r1[i].name.s, batch.r2[i].name.s);
+		}
+	}
+	return reader.good() ? 0 : 1;
+}
@@ -0,0 +1,25 @@
+#include <cstdio>
+#include "pairedreader.h"
+
+int main(int argc, char *argv[])
+{
+	if (argc < 3) {
+		fprintf(stderr, "Usage: %s <r1.fasta> <r2.fasta> \n", argv[0]);
+		return 1;
+	}
+	PairedReader reader(argv[1], argv[2], 4096, false);
+	SeqPairBatch batch;
+	while (reader.read(batch)) {
+		for (int i = 0; i < batch.n; ++i) {
+			const krec_t* seq1 = &batch.r1[i];
+			const krec_t* seq2 = &batch.r2[i];
+			if (seq1->qual.l != seq1->seq.l) {
+				printf("r1: %s\t%s\t%s\n", seq1->name.s, seq1->seq.s, seq1->qual.s);
+			}
+			if (seq2->qual.l != seq2->seq.l) {
+				printf("r2: %s\t%s\t%s\n", seq2->name.s, seq2->seq.s, seq2->qual.s);
+			}
+		}
+	}
+	return reader.good() ? 0 : 1;
+}